@@ -0,0 +1,438 @@
+// Microbenchmarks of the helper library's exported functions, called
+// directly from C: the cost of each native entry point without NativeCall
+// and Raku around it. bench/run.raku compiles this against the sources in
+// src/ and merges its output with the Raku scenarios.
+//
+//   micro [min-seconds]
+//
+// Prints one JSON object mapping benchmark names to nanoseconds per
+// operation, the best of three timed runs.
+#include <Python.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ===== HELPER API =====
+// Declared here rather than shared through a header, as Raku declares them
+// through NativeCall
+
+typedef struct {
+    PyObject *(*call_raku_object)(int, PyObject *, PyObject **);
+    PyObject *(*call_raku_method)(int, char *, PyObject *, PyObject **);
+} RakuCallbacks;
+
+int python3_init_python(RakuCallbacks callbacks);
+PyObject* python3_fetch_exception(PyObject **value, PyObject **traceback);
+int python3_type_tag(PyObject *obj);
+void python3_instrument_enable(int enabled);
+int64_t python3_int_to_long(PyObject *obj);
+PyObject* python3_int_from_long(int64_t value);
+double python3_float_to_double(PyObject *obj);
+PyObject* python3_float_from_double(double value);
+PyObject* python3_str_from_utf8(const char *str, Py_ssize_t size);
+const char* python3_str_to_utf8_zero_copy(PyObject *obj, Py_ssize_t *size);
+PyObject* python3_dict_lookup(PyObject *dict, PyObject *key);
+PyObject* python3_get_attr(PyObject *obj, const char *name);
+PyObject* python3_get_attr_or_call(PyObject *obj, PyObject *name);
+PyObject* python3_intern(const char *name);
+PyObject* python3_compile(const char *code, int is_eval);
+PyObject* python3_eval_code(PyObject *code, PyObject *globals, PyObject *locals);
+PyObject* python3_exec(const char *code, PyObject *globals, PyObject *locals);
+PyObject* python3_call(PyObject *callable, PyObject *args, PyObject *kwargs);
+PyObject* python3_call_method(PyObject *obj, const char *method, PyObject *args, PyObject *kwargs);
+PyObject* python3_vectorcall(PyObject *callable, PyObject **args, Py_ssize_t nargs, PyObject *kwnames);
+PyObject* python3_vectorcall_method(PyObject *obj, PyObject *name, PyObject **args, Py_ssize_t nargs, PyObject *kwnames);
+PyObject* python3_list_from_int64(const int64_t *values, Py_ssize_t count);
+int python3_list_to_int64(PyObject *seq, int64_t *out, Py_ssize_t count);
+void* python3_flatten(PyObject *obj);
+void python3_flat_free(void *flat);
+PyObject* python3_get_iter(PyObject *obj);
+Py_ssize_t python3_iter_next_batch(PyObject *iter, Py_ssize_t n, PyObject **out);
+void* python3_str_batch(PyObject **items, Py_ssize_t count);
+void python3_str_batch_free(void *batch);
+void python3_batch_int_to_py(int64_t *values, int32_t count, PyObject **results);
+void python3_batch_py_to_num(PyObject **values, int32_t count, double *results);
+PyObject* python3_create_int_list(int64_t *values, int32_t count);
+int python3_list_is_homogeneous_int(PyObject *list);
+void* python3_array_info(PyObject *obj);
+void python3_array_release(void *info);
+int python3_array_reduce(void *a, int op, double *out);
+int python3_array_dot(void *a, void *b, double *out);
+int python3_array_axpy(double alpha, void *x, void *y);
+
+// ===== FIXTURES =====
+
+#define N 1000
+
+static PyObject *globals;
+static PyObject *add;          // def add(a, b): return a + b
+static PyObject *fails;        // def fails(): raise ValueError
+static PyObject *point;        // Point(1, 2), with a norm() method
+static PyObject *norm_name;    // Interned "norm"
+static PyObject *x_name;       // Interned "x"
+static PyObject *expression;   // Compiled "add(1, 2)"
+static PyObject *big_int;      // 2**40, outside the small int cache
+static PyObject *short_str;
+static PyObject *long_str;     // 4 KiB
+static PyObject *dict;         // N str keys
+static PyObject *dict_key;
+static PyObject *int_list;     // range(N) as a list
+static PyObject *float_items[N];
+static PyObject *str_items[N];
+static PyObject *rows;         // [[i, "row", 0.5]] * 100
+static PyObject *vector_a;     // array.array('d'), N * 10 items
+static PyObject *vector_b;
+static int64_t int_values[N];
+static char text[4096];
+
+static PyObject* global(const char *name) {
+    PyObject *obj = PyDict_GetItemString(globals, name);
+    if (!obj) {
+        fprintf(stderr, "fixture %s is missing\n", name);
+        exit(1);
+    }
+    Py_INCREF(obj);
+    return obj;
+}
+
+static void setup(void) {
+    RakuCallbacks callbacks = {0};
+    if (python3_init_python(callbacks) != 0) {
+        fprintf(stderr, "cannot start Python\n");
+        exit(1);
+    }
+
+    globals = PyDict_New();
+    PyDict_SetItemString(globals, "__builtins__", PyEval_GetBuiltins());
+    PyObject *ran = PyRun_String(
+        "import array\n"
+        "def add(a, b):\n"
+        "    return a + b\n"
+        "def fails():\n"
+        "    raise ValueError('expected')\n"
+        "class Point:\n"
+        "    def __init__(self, x, y):\n"
+        "        self.x, self.y = x, y\n"
+        "    def norm(self):\n"
+        "        return self.x * self.x + self.y * self.y\n"
+        "point = Point(1, 2)\n"
+        "big_int = 2 ** 40\n"
+        "short_str = 'sixteen chars ok'\n"
+        "table = {'key%d' % i: i for i in range(1000)}\n"
+        "int_list = list(range(1000))\n"
+        "floats = [i * 0.5 for i in range(1000)]\n"
+        "strs = ['item %d' % i for i in range(1000)]\n"
+        "rows = [[i, 'row', 0.5] for i in range(100)]\n"
+        "vector_a = array.array('d', range(10000))\n"
+        "vector_b = array.array('d', range(10000))\n",
+        Py_file_input, globals, globals);
+    if (!ran) {
+        PyErr_Print();
+        exit(1);
+    }
+    Py_DECREF(ran);
+
+    add = global("add");
+    fails = global("fails");
+    point = global("point");
+    big_int = global("big_int");
+    short_str = global("short_str");
+    dict = global("table");
+    int_list = global("int_list");
+    rows = global("rows");
+    vector_a = global("vector_a");
+    vector_b = global("vector_b");
+    norm_name = python3_intern("norm");
+    x_name = python3_intern("x");
+    dict_key = PyUnicode_FromString("key500");
+    expression = python3_compile("add(1, 2)", 1);
+
+    PyObject *floats = global("floats"), *strs = global("strs");
+    for (Py_ssize_t i = 0; i < N; i++) {
+        float_items[i] = PyList_GET_ITEM(floats, i);
+        str_items[i] = PyList_GET_ITEM(strs, i);
+        int_values[i] = i * 1000003;
+    }
+    memset(text, 'x', sizeof(text));
+    long_str = PyUnicode_FromStringAndSize(text, sizeof(text));
+}
+
+// ===== BENCHMARKS =====
+// Each runs its operation n times
+
+static void check(PyObject *result) {
+    if (!result) {
+        PyErr_Print();
+        exit(1);
+    }
+    Py_DECREF(result);
+}
+
+static void int_from_long(long n) {
+    for (long i = 0; i < n; i++) check(python3_int_from_long(((int64_t)1 << 40) + i));
+}
+
+static void int_to_long(long n) {
+    volatile int64_t sink;
+    for (long i = 0; i < n; i++) sink = python3_int_to_long(big_int);
+    (void)sink;
+}
+
+static void float_round_trip(long n) {
+    volatile double sink;
+    for (long i = 0; i < n; i++) {
+        PyObject *f = python3_float_from_double(i * 0.5);
+        sink = python3_float_to_double(f);
+        Py_DECREF(f);
+    }
+    (void)sink;
+}
+
+static void str_from_utf8_short(long n) {
+    for (long i = 0; i < n; i++) check(python3_str_from_utf8(text, 16));
+}
+
+static void str_from_utf8_4k(long n) {
+    for (long i = 0; i < n; i++) check(python3_str_from_utf8(text, sizeof(text)));
+}
+
+static void str_to_utf8(long n) {
+    Py_ssize_t size;
+    volatile const char *sink;
+    for (long i = 0; i < n; i++) sink = python3_str_to_utf8_zero_copy(i & 1 ? short_str : long_str, &size);
+    (void)sink;
+}
+
+static void type_tag(long n) {
+    volatile int sink;
+    for (long i = 0; i < n; i++) sink = python3_type_tag(i & 1 ? short_str : big_int);
+    (void)sink;
+}
+
+static void dict_lookup(long n) {
+    for (long i = 0; i < n; i++) check(python3_dict_lookup(dict, dict_key));
+}
+
+static void get_attr(long n) {
+    for (long i = 0; i < n; i++) check(python3_get_attr(point, "x"));
+}
+
+static void get_attr_interned(long n) {
+    for (long i = 0; i < n; i++) check(python3_get_attr_or_call(point, x_name));
+}
+
+static void call_tuple(long n) {
+    for (long i = 0; i < n; i++) {
+        PyObject *args = Py_BuildValue("(ii)", 1, 2);
+        check(python3_call(add, args, NULL));
+        Py_DECREF(args);
+    }
+}
+
+// The vectorcall helpers take over the argument references, as the
+// NativeCall side hands them new ones
+static void call_vector(long n) {
+    for (long i = 0; i < n; i++) {
+        PyObject *args[2] = { big_int, big_int };
+        Py_INCREF(big_int);
+        Py_INCREF(big_int);
+        check(python3_vectorcall(add, args, 2, NULL));
+    }
+}
+
+static void call_method_by_name(long n) {
+    for (long i = 0; i < n; i++) check(python3_call_method(point, "norm", NULL, NULL));
+}
+
+static void call_method_vector(long n) {
+    PyObject *args[1];  // Receiver slot
+    for (long i = 0; i < n; i++) check(python3_vectorcall_method(point, norm_name, args, 0, NULL));
+}
+
+static void eval_compiled(long n) {
+    for (long i = 0; i < n; i++) check(python3_eval_code(expression, globals, NULL));
+}
+
+static void exec_cached(long n) {
+    for (long i = 0; i < n; i++) check(python3_exec("counter = 1", globals, NULL));
+}
+
+// Raise, fetch and drop an exception, as a caught PythonError does
+static void error_path(long n) {
+    for (long i = 0; i < n; i++) {
+        if (python3_vectorcall(fails, NULL, 0, NULL)) exit(1);
+        PyObject *value, *traceback;
+        PyObject *type = python3_fetch_exception(&value, &traceback);
+        Py_XDECREF(type);
+        Py_XDECREF(value);
+        Py_XDECREF(traceback);
+    }
+}
+
+// type_tag with the native counters switched on, for their overhead
+static void type_tag_instrumented(long n) {
+    python3_instrument_enable(1);
+    type_tag(n);
+    python3_instrument_enable(0);
+}
+
+static void list_from_int64(long n) {
+    for (long i = 0; i < n; i++) check(python3_list_from_int64(int_values, N));
+}
+
+static void list_to_int64(long n) {
+    int64_t out[N];
+    for (long i = 0; i < n; i++) python3_list_to_int64(int_list, out, N);
+}
+
+static void flatten_rows(long n) {
+    for (long i = 0; i < n; i++) python3_flat_free(python3_flatten(rows));
+}
+
+static void iterate_batched(long n) {
+    PyObject *items[100];
+    for (long i = 0; i < n; i++) {
+        PyObject *iter = python3_get_iter(int_list);
+        Py_ssize_t got;
+        while ((got = python3_iter_next_batch(iter, 100, items)) > 0) {
+            for (Py_ssize_t k = 0; k < got; k++) Py_DECREF(items[k]);
+        }
+        Py_DECREF(iter);
+    }
+}
+
+static void str_batch(long n) {
+    for (long i = 0; i < n; i++) python3_str_batch_free(python3_str_batch(str_items, N));
+}
+
+static void batch_int_to_py(long n) {
+    PyObject *out[N];
+    for (long i = 0; i < n; i++) {
+        python3_batch_int_to_py(int_values, N, out);
+        for (int k = 0; k < N; k++) Py_DECREF(out[k]);
+    }
+}
+
+static void batch_py_to_num(long n) {
+    double out[N];
+    for (long i = 0; i < n; i++) python3_batch_py_to_num(float_items, N, out);
+}
+
+static void create_int_list(long n) {
+    for (long i = 0; i < n; i++) check(python3_create_int_list(int_values, N));
+}
+
+static void homogeneous_int(long n) {
+    volatile int sink;
+    for (long i = 0; i < n; i++) sink = python3_list_is_homogeneous_int(int_list);
+    (void)sink;
+}
+
+static void array_info(long n) {
+    for (long i = 0; i < n; i++) python3_array_release(python3_array_info(vector_a));
+}
+
+static void array_sum(long n) {
+    void *a = python3_array_info(vector_a);
+    double out;
+    for (long i = 0; i < n; i++) python3_array_reduce(a, 0, &out);
+    python3_array_release(a);
+}
+
+static void array_dot(long n) {
+    void *a = python3_array_info(vector_a), *b = python3_array_info(vector_b);
+    double out;
+    for (long i = 0; i < n; i++) python3_array_dot(a, b, &out);
+    python3_array_release(a);
+    python3_array_release(b);
+}
+
+static void array_axpy(long n) {
+    void *a = python3_array_info(vector_a), *b = python3_array_info(vector_b);
+    for (long i = 0; i < n; i++) python3_array_axpy(i & 1 ? 1.0 : -1.0, a, b);
+    python3_array_release(a);
+    python3_array_release(b);
+}
+
+static const struct {
+    const char *name;
+    void (*run)(long n);
+} benchmarks[] = {
+    {"helper/int_from_long", int_from_long},
+    {"helper/int_to_long", int_to_long},
+    {"helper/float_round_trip", float_round_trip},
+    {"helper/str_from_utf8_16b", str_from_utf8_short},
+    {"helper/str_from_utf8_4k", str_from_utf8_4k},
+    {"helper/str_to_utf8_zero_copy", str_to_utf8},
+    {"helper/type_tag", type_tag},
+    {"helper/type_tag_instrumented", type_tag_instrumented},
+    {"helper/dict_lookup", dict_lookup},
+    {"helper/get_attr", get_attr},
+    {"helper/get_attr_interned", get_attr_interned},
+    {"helper/call_tuple", call_tuple},
+    {"helper/vectorcall", call_vector},
+    {"helper/call_method", call_method_by_name},
+    {"helper/vectorcall_method", call_method_vector},
+    {"helper/eval_compiled", eval_compiled},
+    {"helper/exec_cached", exec_cached},
+    {"helper/error_fetch", error_path},
+    {"helper/list_from_int64_1k", list_from_int64},
+    {"helper/list_to_int64_1k", list_to_int64},
+    {"helper/flatten_100_rows", flatten_rows},
+    {"helper/iter_next_batch_1k", iterate_batched},
+    {"helper/str_batch_1k", str_batch},
+    {"batch/int_to_py_1k", batch_int_to_py},
+    {"batch/py_to_num_1k", batch_py_to_num},
+    {"batch/create_int_list_1k", create_int_list},
+    {"batch/homogeneous_int_1k", homogeneous_int},
+    {"numpy/array_info", array_info},
+    {"numpy/sum_10k", array_sum},
+    {"numpy/dot_10k", array_dot},
+    {"numpy/axpy_10k", array_axpy},
+};
+
+// ===== DRIVER =====
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Grow n until one run takes min_seconds, then keep the best of three
+static double ns_per_op(void (*run)(long n), double min_seconds) {
+    long n = 1;
+    double elapsed;
+    for (;;) {
+        double start = now();
+        run(n);
+        elapsed = now() - start;
+        if (elapsed >= min_seconds) break;
+        n = elapsed > 0 ? (long)(n * 1.2 * min_seconds / elapsed) + 1 : n * 10;
+    }
+    double best = elapsed;
+    for (int i = 0; i < 2; i++) {
+        double start = now();
+        run(n);
+        elapsed = now() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return best * 1e9 / n;
+}
+
+int main(int argc, char **argv) {
+    double min_seconds = argc > 1 ? atof(argv[1]) : 0.1;
+    setup();
+
+    size_t count = sizeof(benchmarks) / sizeof(benchmarks[0]);
+    printf("{\n");
+    for (size_t i = 0; i < count; i++) {
+        printf("  \"%s\": %.2f%s\n", benchmarks[i].name, ns_per_op(benchmarks[i].run, min_seconds),
+               i + 1 < count ? "," : "");
+        fflush(stdout);
+    }
+    printf("}\n");
+    return 0;
+}
@@ -0,0 +1,201 @@
+// Arrow C Data Interface helpers for zero-copy columnar exchange
+//
+// Columns move between Raku and pyarrow (or any other Arrow producer) as
+// ArrowSchema/ArrowArray structs, which only describe existing buffers.
+// See https://arrow.apache.org/docs/format/CDataInterface.html
+#include <Python.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct ArrowSchema {
+    const char *format;
+    const char *name;
+    const char *metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema **children;
+    struct ArrowSchema *dictionary;
+    void (*release)(struct ArrowSchema *);
+    void *private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void **buffers;
+    struct ArrowArray **children;
+    struct ArrowArray *dictionary;
+    void (*release)(struct ArrowArray *);
+    void *private_data;
+};
+
+// Linked into the same library as python3_helper.c, whose exported GIL
+// helpers know about threaded mode and pool sub-interpreters
+int python3_gil_ensure(void);
+void python3_gil_release(int state);
+
+static void arrow_gil_release(int *state) {
+    python3_gil_release(*state);
+}
+
+#define ARROW_GIL int arrow_gil_state __attribute__((cleanup(arrow_gil_release))) = python3_gil_ensure()
+
+// ===== IMPORT =====
+// A producer's structs, moved into memory Raku owns. Raku reads the
+// schema and buffers in place and calls python3_arrow_release when the
+// last column view is gone, which lets the producer free its buffers.
+
+typedef struct {
+    struct ArrowSchema schema;
+    struct ArrowArray array;
+} PythonArrowData;
+
+// Empty structs, e.g. for pyarrow's _export_to_c(array_addr, schema_addr)
+PythonArrowData* python3_arrow_alloc(void) {
+    return calloc(1, sizeof(PythonArrowData));
+}
+
+// Move the structs out of the capsules returned by __arrow_c_array__.
+// The capsules' own release then has nothing left to free. NULL when
+// the objects are not live Arrow capsules.
+PythonArrowData* python3_arrow_take(PyObject *schema_capsule, PyObject *array_capsule) {
+    ARROW_GIL;
+    struct ArrowSchema *schema = PyCapsule_GetPointer(schema_capsule, "arrow_schema");
+    struct ArrowArray *array = schema ? PyCapsule_GetPointer(array_capsule, "arrow_array") : NULL;
+    if (!schema || !array) {
+        PyErr_Clear();
+        return NULL;
+    }
+    if (!schema->release || !array->release) return NULL;
+
+    PythonArrowData *data = python3_arrow_alloc();
+    if (!data) return NULL;
+    data->schema = *schema;
+    data->array = *array;
+    schema->release = NULL;
+    array->release = NULL;
+    return data;
+}
+
+void python3_arrow_release(PythonArrowData *data) {
+    if (!data) return;
+    // Producers such as pyarrow may drop Python references on release
+    ARROW_GIL;
+    if (data->array.release) data->array.release(&data->array);
+    if (data->schema.release) data->schema.release(&data->schema);
+    free(data);
+}
+
+// ===== EXPORT =====
+// A Raku column described by heap-allocated structs whose buffers point
+// into Raku memory. Raku keeps that memory pinned under a handle; when the
+// consumer releases the array, the handle is queued for Raku to unpin.
+// Release can happen on any thread, so the queue has its own lock.
+
+static pthread_mutex_t arrow_released_lock = PTHREAD_MUTEX_INITIALIZER;
+static int64_t *arrow_released = NULL;
+static Py_ssize_t arrow_released_count = 0;
+static Py_ssize_t arrow_released_cap = 0;
+
+typedef struct {
+    const void *buffers[3];
+    int64_t handle;
+} ArrowExportPrivate;
+
+static void arrow_export_release_schema(struct ArrowSchema *schema) {
+    free((char *)schema->format);
+    schema->release = NULL;
+}
+
+static void arrow_export_release_array(struct ArrowArray *array) {
+    ArrowExportPrivate *priv = array->private_data;
+
+    pthread_mutex_lock(&arrow_released_lock);
+    if (arrow_released_count == arrow_released_cap) {
+        Py_ssize_t cap = arrow_released_cap ? arrow_released_cap * 2 : 64;
+        int64_t *grown = realloc(arrow_released, cap * sizeof(int64_t));
+        if (grown) {
+            arrow_released = grown;
+            arrow_released_cap = cap;
+        }
+    }
+    // Without room the pin is simply kept for the rest of the process
+    if (arrow_released_count < arrow_released_cap) {
+        arrow_released[arrow_released_count++] = priv->handle;
+    }
+    pthread_mutex_unlock(&arrow_released_lock);
+
+    free(priv);
+    array->release = NULL;
+}
+
+typedef struct {
+    struct ArrowSchema *schema;
+    struct ArrowArray *array;
+} PythonArrowExport;
+
+// Describe a flat column: primitive types have buffers (validity, values),
+// string and binary types (validity, offsets, bytes). validity may be NULL.
+// null_count -1 means unknown.
+PythonArrowExport* python3_arrow_export_new(const char *format, int64_t length, int64_t null_count,
+                                            int64_t n_buffers, const void **buffers, int64_t handle) {
+    if (n_buffers < 2 || n_buffers > 3) return NULL;
+
+    PythonArrowExport *out = calloc(1, sizeof(PythonArrowExport));
+    ArrowExportPrivate *priv = calloc(1, sizeof(ArrowExportPrivate));
+    char *fmt = strdup(format);
+    if (out) {
+        out->schema = calloc(1, sizeof(struct ArrowSchema));
+        out->array = calloc(1, sizeof(struct ArrowArray));
+    }
+    if (!out || !priv || !fmt || !out->schema || !out->array) {
+        if (out) {
+            free(out->schema);
+            free(out->array);
+        }
+        free(out);
+        free(priv);
+        free(fmt);
+        return NULL;
+    }
+
+    out->schema->format = fmt;
+    out->schema->name = "";
+    out->schema->flags = 2;  // ARROW_FLAG_NULLABLE
+    out->schema->release = arrow_export_release_schema;
+
+    memcpy(priv->buffers, buffers, n_buffers * sizeof(void *));
+    priv->handle = handle;
+    out->array->length = length;
+    out->array->null_count = null_count;
+    out->array->n_buffers = n_buffers;
+    out->array->buffers = priv->buffers;
+    out->array->release = arrow_export_release_array;
+    out->array->private_data = priv;
+    return out;
+}
+
+// Free the struct memory once the consumer has moved the contents out;
+// anything it did not take is released here
+void python3_arrow_export_free(PythonArrowExport *out) {
+    if (!out) return;
+    if (out->array->release) out->array->release(out->array);
+    if (out->schema->release) out->schema->release(out->schema);
+    free(out->array);
+    free(out->schema);
+    free(out);
+}
+
+// Copy up to max handles of exported columns consumers no longer use into out
+Py_ssize_t python3_arrow_take_released(int64_t *out, Py_ssize_t max) {
+    pthread_mutex_lock(&arrow_released_lock);
+    Py_ssize_t n = arrow_released_count < max ? arrow_released_count : max;
+    arrow_released_count -= n;
+    memcpy(out, arrow_released + arrow_released_count, n * sizeof(int64_t));
+    pthread_mutex_unlock(&arrow_released_lock);
+    return n;
+}
@@ -0,0 +1,302 @@
+// asyncio event loop on a dedicated thread for Inline::Python3::Async
+//
+// The loop runs forever on its own OS thread and releases the GIL while it
+// waits for I/O. Raku submits awaitables from any thread; each one gets a
+// done callback that queues its outcome. A Raku thread blocks in
+// python3_async_wait, without the GIL, and completes the Promises.
+#include <Python.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Linked into the same library as python3_helper.c, whose exported GIL
+// helpers know about threaded mode
+int python3_gil_ensure(void);
+void python3_gil_release(int state);
+
+static void async_gil_release(int *state) {
+    python3_gil_release(*state);
+}
+
+#define ASYNC_GIL int async_gil_state __attribute__((cleanup(async_gil_release))) = python3_gil_ensure()
+
+static const char *async_support_source =
+    "import asyncio\n"
+    "async def await_any(awaitable):\n"
+    "    return await awaitable\n"
+    "def drain(loop):\n"
+    "    tasks = asyncio.all_tasks(loop)\n"
+    "    for task in tasks:\n"
+    "        task.cancel()\n"
+    "    if tasks:\n"
+    "        loop.run_until_complete(asyncio.gather(*tasks, return_exceptions=True))\n"
+    "    loop.run_until_complete(loop.shutdown_asyncgens())\n"
+    "    loop.close()\n";
+
+typedef struct {
+    int64_t id;
+    int64_t failed;
+    PyObject *result;  // Value or exception; new reference
+} AsyncCompletion;
+
+typedef struct {
+    PyObject *loop;
+    PyObject *support;         // Globals of async_support_source
+    PyObject *run_threadsafe;  // asyncio.run_coroutine_threadsafe
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    AsyncCompletion *done;
+    Py_ssize_t done_count;
+    Py_ssize_t done_cap;
+    Py_ssize_t reserved;       // Slots of done kept for submissions still running
+    int stopped;
+} PythonAsyncLoop;
+
+// What a done callback needs to know about its submission
+typedef struct {
+    PythonAsyncLoop *loop;
+    int64_t id;
+} AsyncTicket;
+
+// Keep a slot of done for one submission, so that its outcome can always
+// be queued. -1 when there is no memory for it.
+static int async_reserve(PythonAsyncLoop *self) {
+    pthread_mutex_lock(&self->lock);
+    if (self->done_count + self->reserved == self->done_cap) {
+        Py_ssize_t cap = self->done_cap ? self->done_cap * 2 : 64;
+        AsyncCompletion *grown = realloc(self->done, cap * sizeof(AsyncCompletion));
+        if (!grown) {
+            pthread_mutex_unlock(&self->lock);
+            return -1;
+        }
+        self->done = grown;
+        self->done_cap = cap;
+    }
+    self->reserved++;
+    pthread_mutex_unlock(&self->lock);
+    return 0;
+}
+
+// Queue the outcome of a submission into the slot reserved for it
+static void async_push(PythonAsyncLoop *self, int64_t id, int failed, PyObject *result) {
+    pthread_mutex_lock(&self->lock);
+    self->reserved--;
+    self->done[self->done_count++] = (AsyncCompletion){ id, failed, result };
+    pthread_cond_signal(&self->changed);
+    pthread_mutex_unlock(&self->lock);
+}
+
+// Take the current Python exception as the outcome of submission id
+static void async_push_error(PythonAsyncLoop *self, int64_t id) {
+    PyObject *type, *value, *traceback;
+    PyErr_Fetch(&type, &value, &traceback);
+    PyErr_NormalizeException(&type, &value, &traceback);
+    if (value && traceback) PyException_SetTraceback(value, traceback);
+    async_push(self, id, 1, value ? value : (Py_XINCREF(type), type));
+    Py_XDECREF(type);
+    Py_XDECREF(traceback);
+}
+
+// Done callback of the concurrent.futures.Future of a submission; runs on
+// the loop thread, with the GIL
+static PyObject* async_future_done(PyObject *capsule, PyObject *future) {
+    AsyncTicket *ticket = PyCapsule_GetPointer(capsule, "inline_python3.async");
+    if (!ticket) return NULL;
+
+    PyObject *result = PyObject_CallMethod(future, "result", NULL);
+    if (result) {
+        async_push(ticket->loop, ticket->id, 0, result);
+    }
+    else {
+        // The coroutine raised or was cancelled
+        async_push_error(ticket->loop, ticket->id);
+    }
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef async_future_done_def = {"future_done", async_future_done, METH_O, NULL};
+
+static void async_ticket_free(PyObject *capsule) {
+    free(PyCapsule_GetPointer(capsule, "inline_python3.async"));
+}
+
+static void* async_loop_thread(void *arg) {
+    PythonAsyncLoop *self = arg;
+    PyGILState_STATE gil = PyGILState_Ensure();
+
+    PyObject *result = PyObject_CallMethod(self->loop, "run_forever", NULL);
+    if (result) {
+        // Cancel what is still pending, so that every submission completes
+        Py_DECREF(result);
+        PyObject *drain = PyDict_GetItemString(self->support, "drain");
+        result = drain ? PyObject_CallFunctionObjArgs(drain, self->loop, NULL) : NULL;
+    }
+    if (!result) PyErr_Print();
+    Py_XDECREF(result);
+    PyGILState_Release(gil);
+
+    pthread_mutex_lock(&self->lock);
+    self->stopped = 1;
+    pthread_cond_broadcast(&self->changed);
+    pthread_mutex_unlock(&self->lock);
+    return NULL;
+}
+
+static void async_loop_free(PythonAsyncLoop *self) {
+    for (Py_ssize_t i = 0; i < self->done_count; i++) Py_XDECREF(self->done[i].result);
+    free(self->done);
+    Py_XDECREF(self->loop);
+    Py_XDECREF(self->support);
+    Py_XDECREF(self->run_threadsafe);
+    pthread_mutex_destroy(&self->lock);
+    pthread_cond_destroy(&self->changed);
+    free(self);
+}
+
+// Create a new event loop and start its thread. Needs threaded mode, so
+// that the loop thread can take the GIL. NULL on failure.
+PythonAsyncLoop* python3_async_start(void) {
+    ASYNC_GIL;
+    PythonAsyncLoop *self = calloc(1, sizeof(PythonAsyncLoop));
+    if (!self) return NULL;
+    pthread_mutex_init(&self->lock, NULL);
+    pthread_cond_init(&self->changed, NULL);
+
+    PyObject *asyncio = PyImport_ImportModule("asyncio");
+    if (asyncio) {
+        self->loop = PyObject_CallMethod(asyncio, "new_event_loop", NULL);
+        self->run_threadsafe = PyObject_GetAttrString(asyncio, "run_coroutine_threadsafe");
+        Py_DECREF(asyncio);
+    }
+    if (self->loop && self->run_threadsafe && (self->support = PyDict_New())) {
+        PyDict_SetItemString(self->support, "__builtins__", PyEval_GetBuiltins());
+        PyObject *ran = PyRun_String(async_support_source, Py_file_input, self->support, self->support);
+        Py_XDECREF(ran);
+        if (ran && pthread_create(&self->thread, NULL, async_loop_thread, self) == 0) {
+            return self;
+        }
+    }
+    PyErr_Clear();
+    async_loop_free(self);
+    return NULL;
+}
+
+// Schedule an awaitable on the loop; its outcome is reported under id.
+// Errors while scheduling are reported the same way. -1 without
+// scheduling anything when there is no memory to report the outcome.
+int python3_async_submit(PythonAsyncLoop *self, PyObject *awaitable, int64_t id) {
+    ASYNC_GIL;
+    if (async_reserve(self) < 0) return -1;
+
+    // run_coroutine_threadsafe only takes coroutines; futures and other
+    // awaitables are awaited by one
+    PyObject *coroutine;
+    if (PyCoro_CheckExact(awaitable)) {
+        Py_INCREF(awaitable);
+        coroutine = awaitable;
+    }
+    else {
+        PyObject *await_any = PyDict_GetItemString(self->support, "await_any");
+        coroutine = PyObject_CallFunctionObjArgs(await_any, awaitable, NULL);
+        if (!coroutine) {
+            async_push_error(self, id);
+            return 0;
+        }
+    }
+
+    PyObject *future = PyObject_CallFunctionObjArgs(self->run_threadsafe, coroutine, self->loop, NULL);
+    Py_DECREF(coroutine);
+    if (!future) {
+        async_push_error(self, id);
+        return 0;
+    }
+
+    AsyncTicket *ticket = malloc(sizeof(AsyncTicket));
+    PyObject *capsule = ticket ? PyCapsule_New(ticket, "inline_python3.async", async_ticket_free) : NULL;
+    PyObject *callback = capsule ? PyCFunction_New(&async_future_done_def, capsule) : NULL;
+    PyObject *added = NULL;
+    if (callback) {
+        ticket->loop = self;
+        ticket->id = id;
+        added = PyObject_CallMethod(future, "add_done_callback", "O", callback);
+    }
+    else if (!capsule) {
+        free(ticket);
+        if (!PyErr_Occurred()) PyErr_NoMemory();
+    }
+    Py_XDECREF(capsule);
+    Py_XDECREF(callback);
+    if (added) {
+        Py_DECREF(added);
+    }
+    else {
+        async_push_error(self, id);
+        PyObject *cancelled = PyObject_CallMethod(future, "cancel", NULL);
+        Py_XDECREF(cancelled);
+        PyErr_Clear();
+    }
+    Py_DECREF(future);
+    return 0;
+}
+
+// Block until submissions have completed, then move up to max of them into
+// the arrays; the results are new references. Does not hold the GIL while
+// waiting. Returns -1 once the loop has stopped and nothing is left.
+Py_ssize_t python3_async_wait(PythonAsyncLoop *self, int64_t *ids, int64_t *failed,
+                              PyObject **results, Py_ssize_t max) {
+    pthread_mutex_lock(&self->lock);
+    while (self->done_count == 0 && !self->stopped) {
+        pthread_cond_wait(&self->changed, &self->lock);
+    }
+    Py_ssize_t n = self->done_count < max ? self->done_count : max;
+    for (Py_ssize_t i = 0; i < n; i++) {
+        ids[i] = self->done[i].id;
+        failed[i] = self->done[i].failed;
+        results[i] = self->done[i].result;
+    }
+    self->done_count -= n;
+    memmove(self->done, self->done + n, self->done_count * sizeof(AsyncCompletion));
+    pthread_mutex_unlock(&self->lock);
+    return n == 0 ? -1 : n;
+}
+
+static int async_request_stop(PythonAsyncLoop *self) {
+    ASYNC_GIL;
+    PyObject *stop = PyObject_GetAttrString(self->loop, "stop");
+    PyObject *scheduled = stop ? PyObject_CallMethod(self->loop, "call_soon_threadsafe", "O", stop) : NULL;
+    Py_XDECREF(stop);
+    if (!scheduled) {
+        PyErr_Clear();
+        return -1;
+    }
+    Py_DECREF(scheduled);
+    return 0;
+}
+
+// Stop the loop, cancelling what is still pending, and wait for its thread.
+// The loop thread needs the GIL to finish, so a caller holding it (inside
+// with-gil or a callback from Python) would wait forever: -1 without
+// stopping anything in that case. -2 when the stop could not be scheduled
+// on a running loop, otherwise 0; only then may the loop be freed.
+int python3_async_stop(PythonAsyncLoop *self) {
+    if (PyGILState_Check()) return -1;
+    if (async_request_stop(self) < 0) {
+        // The loop can't be asked to stop; only a thread that has already
+        // finished may be joined and freed
+        pthread_mutex_lock(&self->lock);
+        int stopped = self->stopped;
+        pthread_mutex_unlock(&self->lock);
+        if (!stopped) return -2;
+    }
+    pthread_join(self->thread, NULL);
+    return 0;
+}
+
+// Free a stopped loop once python3_async_wait has returned -1 and no
+// python3_async_submit is still running
+void python3_async_free(PythonAsyncLoop *self) {
+    if (!self) return;
+    ASYNC_GIL;
+    async_loop_free(self);
+}
@@ -2,8 +2,20 @@
 #include <Python.h>
 #include <string.h>
 
+// Linked into the same library as python3_helper.c, whose exported GIL
+// helpers know about threaded mode and pool sub-interpreters
+int python3_gil_ensure(void);
+void python3_gil_release(int state);
+
+static void batch_gil_release(int *state) {
+    python3_gil_release(*state);
+}
+
+#define BATCH_GIL int batch_gil_state __attribute__((cleanup(batch_gil_release))) = python3_gil_ensure()
+
 // Batch convert integers to Python
 void python3_batch_int_to_py(int64_t *values, int32_t count, PyObject **results) {
+    BATCH_GIL;
     for (int32_t i = 0; i < count; i++) {
         // Use cached integers for small values
         if (values[i] >= -5 && values[i] <= 256) {
@@ -16,6 +28,7 @@ void python3_batch_int_to_py(int64_t *values, int32_t count, PyObject **results)
 
 // Batch convert floats to Python
 void python3_batch_num_to_py(double *values, int32_t count, PyObject **results) {
+    BATCH_GIL;
     for (int32_t i = 0; i < count; i++) {
         results[i] = PyFloat_FromDouble(values[i]);
     }
@@ -23,6 +36,7 @@ void python3_batch_num_to_py(double *values, int32_t count, PyObject **results)
 
 // Batch convert strings to Python
 void python3_batch_str_to_py(char **values, int32_t count, PyObject **results) {
+    BATCH_GIL;
     for (int32_t i = 0; i < count; i++) {
         results[i] = PyUnicode_FromString(values[i]);
     }
@@ -30,6 +44,7 @@ void python3_batch_str_to_py(char **values, int32_t count, PyObject **results) {
 
 // Batch convert Python integers to C
 void python3_batch_py_to_int(PyObject **values, int32_t count, int64_t *results) {
+    BATCH_GIL;
     for (int32_t i = 0; i < count; i++) {
         if (PyLong_Check(values[i])) {
             results[i] = PyLong_AsLongLong(values[i]);
@@ -41,6 +56,7 @@ void python3_batch_py_to_int(PyObject **values, int32_t count, int64_t *results)
 
 // Batch convert Python floats to C
 void python3_batch_py_to_num(PyObject **values, int32_t count, double *results) {
+    BATCH_GIL;
     for (int32_t i = 0; i < count; i++) {
         if (PyFloat_Check(values[i])) {
             results[i] = PyFloat_AsDouble(values[i]);
@@ -54,6 +70,7 @@ void python3_batch_py_to_num(PyObject **values, int32_t count, double *results)
 
 // Batch convert Python strings to C
 void python3_batch_py_to_str(PyObject **values, int32_t count, char **results) {
+    BATCH_GIL;
     for (int32_t i = 0; i < count; i++) {
         if (PyUnicode_Check(values[i])) {
             const char *str = PyUnicode_AsUTF8(values[i]);
@@ -66,6 +83,7 @@ void python3_batch_py_to_str(PyObject **values, int32_t count, char **results) {
 
 // Create Python list from array of PyObject pointers
 PyObject* python3_create_list_from_pointers(PyObject **values, int32_t count) {
+    BATCH_GIL;
     PyObject *list = PyList_New(count);
     if (!list) return NULL;
     
@@ -79,6 +97,7 @@ PyObject* python3_create_list_from_pointers(PyObject **values, int32_t count) {
 
 // Create Python tuple from array of PyObject pointers
 PyObject* python3_create_tuple_from_pointers(PyObject **values, int32_t count) {
+    BATCH_GIL;
     PyObject *tuple = PyTuple_New(count);
     if (!tuple) return NULL;
     
@@ -92,6 +111,7 @@ PyObject* python3_create_tuple_from_pointers(PyObject **values, int32_t count) {
 
 // Extract pointers from Python list
 void python3_list_to_pointer_array(PyObject *list, PyObject **results) {
+    BATCH_GIL;
     if (!PyList_Check(list)) return;
     
     Py_ssize_t size = PyList_Size(list);
@@ -102,6 +122,7 @@ void python3_list_to_pointer_array(PyObject *list, PyObject **results) {
 
 // Optimized homogeneous array operations
 PyObject* python3_create_int_list(int64_t *values, int32_t count) {
+    BATCH_GIL;
     PyObject *list = PyList_New(count);
     if (!list) return NULL;
     
@@ -114,6 +135,7 @@ PyObject* python3_create_int_list(int64_t *values, int32_t count) {
 }
 
 PyObject* python3_create_float_list(double *values, int32_t count) {
+    BATCH_GIL;
     PyObject *list = PyList_New(count);
     if (!list) return NULL;
     
@@ -127,6 +149,7 @@ PyObject* python3_create_float_list(double *values, int32_t count) {
 
 // Type checking for homogeneous optimization
 int python3_list_is_homogeneous_int(PyObject *list) {
+    BATCH_GIL;
     if (!PyList_Check(list)) return 0;
     
     Py_ssize_t size = PyList_Size(list);
@@ -139,6 +162,7 @@ int python3_list_is_homogeneous_int(PyObject *list) {
 }
 
 int python3_list_is_homogeneous_float(PyObject *list) {
+    BATCH_GIL;
     if (!PyList_Check(list)) return 0;
     
     Py_ssize_t size = PyList_Size(list);
@@ -151,6 +175,7 @@ int python3_list_is_homogeneous_float(PyObject *list) {
 }
 
 int python3_list_is_homogeneous_str(PyObject *list) {
+    BATCH_GIL;
     if (!PyList_Check(list)) return 0;
     
     Py_ssize_t size = PyList_Size(list);
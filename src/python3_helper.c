@@ -1,11 +1,16 @@
 #include <Python.h>
 #include <datetime.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <time.h>
+#include <pthread.h>
 
 // Forward declarations
 PyObject* PyInit_python3(void);
+static void code_cache_clear(void);
+static void method_cache_clear(void);
 typedef struct {
     PyObject *(*call_raku_object)(int, PyObject *, PyObject **);
     PyObject *(*call_raku_method)(int, char *, PyObject *, PyObject **);
@@ -13,20 +18,462 @@ typedef struct {
 
 static RakuCallbacks raku_callbacks;
 
-// Error handling
+// GIL handling
+// By default the embedding thread holds the GIL for the lifetime of the
+// interpreter. Once python3_enable_threads() has been called the GIL is
+// released and every exported helper takes it for the duration of its work
+// via PY3_GIL, so Raku code may call in from any thread.
+static int threads_enabled = 0;
+static PyThreadState *main_thread_state = NULL;
+
+// Set once the current OS thread owns a persistent Python thread state
+static __thread int gil_thread_pinned = 0;
+
+// Drops the pin when its OS thread exits, so short-lived threads do not
+// leave a PyThreadState behind each
+static pthread_key_t gil_pin_key;
+static pthread_once_t gil_pin_key_once = PTHREAD_ONCE_INIT;
+
+// Set while the current OS thread is running inside a pool sub-interpreter,
+// whose thread state is already current and whose GIL is already held
+static __thread int subinterp_active = 0;
+
+static void gil_pin_release(void *pinned) {
+    // The interpreter, and with it the thread state, may already be gone
+    if (!threads_enabled || !Py_IsInitialized()) return;
+
+    // glibc may already have cleared CPython's own slot for this thread,
+    // so PyGILState cannot find the state; delete it by hand instead
+    PyThreadState *tstate = (PyThreadState *)pinned;
+    PyEval_RestoreThread(tstate);
+    PyThreadState_Clear(tstate);
+    PyEval_ReleaseThread(tstate);
+    PyThreadState_Delete(tstate);
+}
+
+static void gil_pin_key_create(void) {
+    pthread_key_create(&gil_pin_key, gil_pin_release);
+}
+
+static PyGILState_STATE py3_gil_ensure(void) {
+    if (!threads_enabled || subinterp_active) return PyGILState_LOCKED;
+
+    PyGILState_STATE state = PyGILState_Ensure();
+    if (!gil_thread_pinned) {
+        // Keep one extra reference on the thread state so it survives
+        // between helper calls; otherwise the pending exception set by one
+        // call would be gone before python3_fetch_exception could read it.
+        PyGILState_Ensure();
+        gil_thread_pinned = 1;
+        pthread_once(&gil_pin_key_once, gil_pin_key_create);
+        pthread_setspecific(gil_pin_key, PyThreadState_Get());
+    }
+    return state;
+}
+
+static void py3_gil_release(PyGILState_STATE *state) {
+    if (threads_enabled && !subinterp_active) PyGILState_Release(*state);
+}
+
+// ===== INSTRUMENTATION =====
+// Opt-in counters for the bridge's hot paths. Every function that takes
+// the GIL through PY3_GIL owns a static probe; while instrumentation is on
+// it counts calls and the nanoseconds spent inside, after the GIL was
+// taken. While it is off the cost is one branch on entry and one on exit.
+// Probes register themselves on first use and are never unlinked, so a
+// snapshot can walk the list while other threads add to it. Counters use
+// relaxed atomics: pool members on 3.12+ hold different GILs.
+
+typedef struct Py3Probe {
+    const char *name;
+    uint64_t calls;
+    uint64_t nanoseconds;
+    struct Py3Probe *next;
+    int registered;
+} Py3Probe;
+
 typedef struct {
-    PyObject *type;
-    PyObject *value;
-    PyObject *traceback;
-    char *formatted_exception;
-} PythonError;
+    Py3Probe *probe;
+    uint64_t start;  // 0 while instrumentation is off
+} Py3ProbeTiming;
+
+static int instrument_enabled = 0;
+static Py3Probe *probes = NULL;
+
+static struct {
+    uint64_t bytes_to_python;
+    uint64_t bytes_from_python;
+    uint64_t exceptions;
+    uint64_t wrappers_created;
+    uint64_t wrappers_released;
+} instrument;
+
+#define PY3_COUNT(field, n) \
+    do { if (instrument_enabled) __atomic_fetch_add(&instrument.field, (uint64_t)(n), __ATOMIC_RELAXED); } while (0)
+
+static uint64_t py3_clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void py3_probe_leave(Py3ProbeTiming *timing) {
+    if (!timing->start) return;
+
+    Py3Probe *probe = timing->probe;
+    if (!__atomic_exchange_n(&probe->registered, 1, __ATOMIC_ACQ_REL)) {
+        probe->next = __atomic_load_n(&probes, __ATOMIC_ACQUIRE);
+        while (!__atomic_compare_exchange_n(&probes, &probe->next, probe, 1, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+    }
+    __atomic_fetch_add(&probe->calls, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&probe->nanoseconds, py3_clock_ns() - timing->start, __ATOMIC_RELAXED);
+}
+
+#define PY3_PROBE \
+    static Py3Probe py3_probe = { __func__, 0, 0, NULL, 0 }; \
+    Py3ProbeTiming py3_probe_timing __attribute__((cleanup(py3_probe_leave))) = \
+        { &py3_probe, instrument_enabled ? py3_clock_ns() : 0 }
+
+// The probe is declared last, so it is closed while the GIL is still held
+#define PY3_GIL PyGILState_STATE py3_gil_state __attribute__((cleanup(py3_gil_release))) = py3_gil_ensure(); \
+    PY3_PROBE
+
+typedef struct {
+    int64_t enabled;
+    int64_t count;              // Entry points called while enabled
+    const char **names;
+    uint64_t *calls;
+    uint64_t *nanoseconds;
+    uint64_t bytes_to_python;   // Payload of strings, bytes and numeric lists
+    uint64_t bytes_from_python;
+    uint64_t exceptions;        // Fetched by python3_fetch_exception
+    uint64_t wrappers_created;  // Counted whether or not enabled
+    int64_t wrappers_live;
+} Py3InstrumentSnapshot;
+
+void python3_instrument_enable(int enabled) {
+    __atomic_store_n(&instrument_enabled, enabled != 0, __ATOMIC_RELAXED);
+}
+
+// Zero the counters; the wrapper counts describe live state and are kept
+void python3_instrument_reset(void) {
+    for (Py3Probe *probe = __atomic_load_n(&probes, __ATOMIC_ACQUIRE); probe; probe = probe->next) {
+        __atomic_store_n(&probe->calls, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&probe->nanoseconds, 0, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&instrument.bytes_to_python, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&instrument.bytes_from_python, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&instrument.exceptions, 0, __ATOMIC_RELAXED);
+}
+
+// Copy of all counters, for python3_instrument_snapshot_free. Probes that
+// have not been called since the last reset are left out.
+Py3InstrumentSnapshot* python3_instrument_snapshot(void) {
+    Py3InstrumentSnapshot *snapshot = calloc(1, sizeof(Py3InstrumentSnapshot));
+    if (!snapshot) return NULL;
+
+    Py3Probe *head = __atomic_load_n(&probes, __ATOMIC_ACQUIRE);
+    Py_ssize_t total = 0;
+    for (Py3Probe *probe = head; probe; probe = probe->next) total++;
+
+    snapshot->names = malloc((total ? total : 1) * sizeof(char *));
+    snapshot->calls = malloc((total ? total : 1) * sizeof(uint64_t));
+    snapshot->nanoseconds = malloc((total ? total : 1) * sizeof(uint64_t));
+    if (!snapshot->names || !snapshot->calls || !snapshot->nanoseconds) {
+        free(snapshot->names);
+        free(snapshot->calls);
+        free(snapshot->nanoseconds);
+        free(snapshot);
+        return NULL;
+    }
+
+    Py_ssize_t count = 0;
+    for (Py3Probe *probe = head; probe && count < total; probe = probe->next) {
+        uint64_t calls = __atomic_load_n(&probe->calls, __ATOMIC_RELAXED);
+        if (!calls) continue;
+        snapshot->names[count] = probe->name;
+        snapshot->calls[count] = calls;
+        snapshot->nanoseconds[count] = __atomic_load_n(&probe->nanoseconds, __ATOMIC_RELAXED);
+        count++;
+    }
+    snapshot->count = count;
+    snapshot->enabled = __atomic_load_n(&instrument_enabled, __ATOMIC_RELAXED);
+    snapshot->bytes_to_python = __atomic_load_n(&instrument.bytes_to_python, __ATOMIC_RELAXED);
+    snapshot->bytes_from_python = __atomic_load_n(&instrument.bytes_from_python, __ATOMIC_RELAXED);
+    snapshot->exceptions = __atomic_load_n(&instrument.exceptions, __ATOMIC_RELAXED);
+    snapshot->wrappers_created = __atomic_load_n(&instrument.wrappers_created, __ATOMIC_RELAXED);
+    snapshot->wrappers_live = snapshot->wrappers_created -
+                              __atomic_load_n(&instrument.wrappers_released, __ATOMIC_RELAXED);
+    return snapshot;
+}
+
+void python3_instrument_snapshot_free(Py3InstrumentSnapshot *snapshot) {
+    if (!snapshot) return;
+    free(snapshot->names);
+    free(snapshot->calls);
+    free(snapshot->nanoseconds);
+    free(snapshot);
+}
+
+// Release the GIL held since initialization; idempotent
+void python3_enable_threads(void) {
+    if (threads_enabled || !Py_IsInitialized()) return;
+
+    main_thread_state = PyEval_SaveThread();
+    threads_enabled = 1;
+}
+
+int python3_threads_enabled(void) {
+    return threads_enabled;
+}
+
+// Hold the GIL across several helper calls; nested helpers only bump the
+// thread's GIL counter instead of re-acquiring the lock
+int python3_gil_ensure(void) {
+    return (int)py3_gil_ensure();
+}
+
+void python3_gil_release(int state) {
+    PyGILState_STATE gil_state = (PyGILState_STATE)state;
+    py3_gil_release(&gil_state);
+}
+
+// ===== CONSTANT TABLE =====
+// Pointers to None, True, False, the empty tuple and str and the cached
+// small ints, exported once so Raku can pass them without a native call.
+// Raku hands these out without taking a reference, so the helpers treat
+// them like immortal objects (as CPython itself does since 3.12): they
+// are never released here, and gain a reference before being stored.
+
+#define PY3_SMALL_INT_MIN (-5)
+#define PY3_SMALL_INT_MAX 256
+
+typedef struct {
+    PyObject *none;
+    PyObject *py_true;
+    PyObject *py_false;
+    PyObject *empty_tuple;
+    PyObject *empty_str;
+    PyObject **small_ints;  // small_ints[value - small_int_min]
+    int64_t small_int_min;
+    int64_t small_int_max;  // Below small_int_min when ints are not exported
+} Py3Constants;
+
+static Py3Constants constants;
+static PyObject *small_int_table[PY3_SMALL_INT_MAX - PY3_SMALL_INT_MIN + 1];
+
+// Address range of the small int array, for the constant check
+static const char *small_int_lo = NULL, *small_int_hi = NULL;
+
+static void build_constants(void) {
+    constants.none = Py_None;
+    constants.py_true = Py_True;
+    constants.py_false = Py_False;
+    constants.empty_tuple = PyTuple_New(0);
+    constants.empty_str = PyUnicode_New(0, 0);
+    constants.small_ints = small_int_table;
+    constants.small_int_min = PY3_SMALL_INT_MIN;
+    constants.small_int_max = PY3_SMALL_INT_MIN - 1;
+
+    // Only export small ints that CPython caches in one contiguous array,
+    // so that recognizing them is a range check
+    Py_ssize_t count = PY3_SMALL_INT_MAX - PY3_SMALL_INT_MIN + 1;
+    int cached = 1;
+    for (Py_ssize_t i = 0; i < count; i++) {
+        small_int_table[i] = PyLong_FromLong(PY3_SMALL_INT_MIN + i);
+        PyObject *again = PyLong_FromLong(PY3_SMALL_INT_MIN + i);
+        if (!small_int_table[i] || again != small_int_table[i]) cached = 0;
+        Py_XDECREF(again);
+    }
+    Py_ssize_t stride = (char *)small_int_table[1] - (char *)small_int_table[0];
+    for (Py_ssize_t i = 0; cached && i < count; i++) {
+        if ((char *)small_int_table[i] != (char *)small_int_table[0] + i * stride) cached = 0;
+    }
+    PyErr_Clear();
+
+    if (cached && stride > 0) {
+        constants.small_int_max = PY3_SMALL_INT_MAX;
+        small_int_lo = (const char *)small_int_table[0];
+        small_int_hi = (const char *)small_int_table[count - 1];
+    }
+}
+
+static void reset_constants(void) {
+    memset(&constants, 0, sizeof(constants));
+    memset(small_int_table, 0, sizeof(small_int_table));
+    small_int_lo = small_int_hi = NULL;
+}
+
+static int py3_is_constant(PyObject *obj) {
+    if ((const char *)obj >= small_int_lo && (const char *)obj <= small_int_hi) return 1;
+    return obj == constants.none || obj == constants.py_true || obj == constants.py_false ||
+           obj == constants.empty_tuple || obj == constants.empty_str;
+}
+
+// Reference for a slot that steals one
+static PyObject* py3_own(PyObject *obj) {
+    if (obj && py3_is_constant(obj)) Py_INCREF(obj);
+    return obj;
+}
+
+static void py3_release(PyObject *obj) {
+    if (!py3_is_constant(obj)) Py_XDECREF(obj);
+}
+
+Py3Constants* python3_constants(void) {
+    PY3_GIL;
+    if (!constants.none) build_constants();
+    return &constants;
+}
+
+// ===== STARTUP =====
+// Settings for the embedded interpreter, set by python3_set_startup before
+// the first python3_init_python. The defaults are the isolated interpreter
+// used so far: no environment variables, site imported, no optimization.
+static struct {
+    int site_import;
+    int optimization_level;
+    PyMemAllocatorName allocator;
+    char *module_path;  // Prepended to sys.path, separated by os.pathsep
+    char *preload;      // Comma-separated modules imported at startup
+} startup = { 1, 0, PYMEM_ALLOCATOR_NOT_SET, NULL, NULL };
+
+// Seconds spent in each phase of the first initialization
+typedef struct {
+    double pre_initialize;  // Allocator and pre-configuration
+    double initialize;      // Py_InitializeFromConfig, including site
+    double preload;         // Importing the preload modules
+} Py3InitTimes;
+
+static Py3InitTimes init_times;
+
+static double py3_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// PYTHONMALLOC names
+static int py3_allocator(const char *name, PyMemAllocatorName *allocator) {
+    static const struct { const char *name; PyMemAllocatorName value; } names[] = {
+        {"default", PYMEM_ALLOCATOR_DEFAULT},
+        {"debug", PYMEM_ALLOCATOR_DEBUG},
+        {"malloc", PYMEM_ALLOCATOR_MALLOC},
+        {"malloc_debug", PYMEM_ALLOCATOR_MALLOC_DEBUG},
+        {"pymalloc", PYMEM_ALLOCATOR_PYMALLOC},
+        {"pymalloc_debug", PYMEM_ALLOCATOR_PYMALLOC_DEBUG},
+#if PY_VERSION_HEX >= 0x030D0000
+        {"mimalloc", PYMEM_ALLOCATOR_MIMALLOC},
+        {"mimalloc_debug", PYMEM_ALLOCATOR_MIMALLOC_DEBUG},
+#endif
+    };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(name, names[i].name) == 0) {
+            *allocator = names[i].value;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static void py3_set_string(char **slot, const char *value) {
+    free(*slot);
+    *slot = value && *value ? strdup(value) : NULL;
+}
+
+// Configure the interpreter started by the next python3_init_python.
+// allocator, module_path and preload may be NULL. Returns -1 for an unknown
+// allocator name and 1 when Python is already running, which leaves the
+// settings unchanged.
+int python3_set_startup(int site_import, int optimization_level, const char *allocator,
+                        const char *module_path, const char *preload) {
+    PyMemAllocatorName name = PYMEM_ALLOCATOR_NOT_SET;
+    if (allocator && *allocator && py3_allocator(allocator, &name) < 0) return -1;
+    if (Py_IsInitialized()) return 1;
+
+    startup.site_import = site_import;
+    startup.optimization_level = optimization_level;
+    startup.allocator = name;
+    py3_set_string(&startup.module_path, module_path);
+    py3_set_string(&startup.preload, preload);
+    return 0;
+}
+
+Py3InitTimes* python3_init_times(void) {
+    return &init_times;
+}
+
+// Uncaught exceptions are reported to Raku, not printed
+static PyObject* py3_quiet_excepthook(PyObject *self, PyObject *args) {
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef py3_quiet_excepthook_def = {"excepthook", py3_quiet_excepthook, METH_VARARGS, NULL};
+
+#ifdef _WIN32
+#define PY3_PATHSEP ";"
+#else
+#define PY3_PATHSEP ":"
+#endif
+
+// Put the module path in front of sys.path. Isolated mode ignores
+// PYTHONPATH, and since 3.11 also its PyConfig counterpart.
+static int py3_prepend_path(void) {
+    if (!startup.module_path) return 0;
+
+    PyObject *path = PySys_GetObject("path");  // Borrowed
+    char *dirs = strdup(startup.module_path);
+    if (!path || !dirs) {
+        free(dirs);
+        PyErr_SetString(PyExc_RuntimeError, "cannot extend sys.path");
+        return -1;
+    }
+    int result = 0;
+    Py_ssize_t at = 0;
+    char *state = NULL;
+    for (char *dir = strtok_r(dirs, PY3_PATHSEP, &state); dir; dir = strtok_r(NULL, PY3_PATHSEP, &state)) {
+        PyObject *entry = PyUnicode_DecodeFSDefault(dir);
+        if (!entry || PyList_Insert(path, at++, entry) < 0) result = -1;
+        Py_XDECREF(entry);
+        if (result < 0) break;
+    }
+    free(dirs);
+    return result;
+}
+
+// Import the preload modules; -1 with the ImportError pending on failure
+static int py3_preload(void) {
+    if (!startup.preload) return 0;
+
+    char *names = strdup(startup.preload);
+    if (!names) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    int result = 0;
+    char *state = NULL;
+    for (char *name = strtok_r(names, ", ", &state); name; name = strtok_r(NULL, ", ", &state)) {
+        PyObject *module = PyImport_ImportModule(name);
+        if (!module) {
+            result = -1;
+            break;
+        }
+        Py_DECREF(module);
+    }
+    free(names);
+    return result;
+}
 
-// Initialize Python interpreter with better error handling
+// Initialize Python interpreter with better error handling. Returns -1 when
+// the interpreter cannot start and -2 when the module path or a preload
+// module cannot be set up, with the exception pending.
 int python3_init_python(RakuCallbacks callbacks) {
     raku_callbacks = callbacks;
     
     // Check if Python is already initialized
     if (Py_IsInitialized()) {
+        // Later instances may be created after threaded mode dropped the GIL
+        PY3_GIL;
         PyDateTime_IMPORT;
         return 0;
     }
@@ -34,14 +481,30 @@ int python3_init_python(RakuCallbacks callbacks) {
     // Import our module BEFORE initializing Python
     PyImport_AppendInittab("python3", &PyInit_python3);
     
+    // The allocator can only be chosen before anything is allocated
+    double start = py3_now();
+    PyPreConfig preconfig;
+    PyPreConfig_InitPythonConfig(&preconfig);
+    preconfig.isolated = 1;
+    preconfig.use_environment = 0;
+    preconfig.allocator = startup.allocator;
+    PyStatus status = Py_PreInitialize(&preconfig);
+    if (PyStatus_Exception(status)) {
+        return -1;
+    }
+    init_times.pre_initialize = py3_now() - start;
+    
     // Configure Python for embedding
+    start = py3_now();
     PyConfig config;
     PyConfig_InitPythonConfig(&config);
     config.isolated = 1;
     config.use_environment = 0;
+    config.site_import = startup.site_import;
+    config.optimization_level = startup.optimization_level;
     
     // Initialize Python
-    PyStatus status = Py_InitializeFromConfig(&config);
+    status = Py_InitializeFromConfig(&config);
     PyConfig_Clear(&config);
     
     if (PyStatus_Exception(status)) {
@@ -50,250 +513,348 @@ int python3_init_python(RakuCallbacks callbacks) {
     
     PyDateTime_IMPORT;
     
-    return 0;
+    PyObject *excepthook = PyCFunction_New(&py3_quiet_excepthook_def, NULL);
+    if (!excepthook || PySys_SetObject("excepthook", excepthook) < 0) PyErr_Clear();
+    Py_XDECREF(excepthook);
+    init_times.initialize = py3_now() - start;
+    
+    start = py3_now();
+    int preloaded = py3_prepend_path() < 0 ? -1 : py3_preload();
+    init_times.preload = py3_now() - start;
+    
+    return preloaded < 0 ? -2 : 0;
 }
 
 // Cleanup Python interpreter
 int python3_destroy_python() {
+    if (threads_enabled) {
+        PyEval_RestoreThread(main_thread_state);
+        main_thread_state = NULL;
+        threads_enabled = 0;
+    }
+    code_cache_clear();
+    method_cache_clear();
+    reset_constants();
     return Py_FinalizeEx();
 }
 
-// Enhanced error fetching with traceback
-void python3_fetch_error(PythonError *error) {
-    PyErr_Fetch(&error->type, &error->value, &error->traceback);
-    
-    if (!error->type) {
-        error->formatted_exception = NULL;
-        return;
-    }
-    
-    PyErr_NormalizeException(&error->type, &error->value, &error->traceback);
-    
-    // Format the exception with traceback
+// Error handling
+// Take the pending exception, if any: returns its type (NULL when none is
+// pending) and stores the value and traceback. Nothing is formatted here,
+// so exceptions that Raku catches and handles stay cheap.
+PyObject* python3_fetch_exception(PyObject **value, PyObject **traceback) {
+    PY3_GIL;
+    PyObject *type;
+    PyErr_Fetch(&type, value, traceback);
+    if (!type) return NULL;
+
+    PY3_COUNT(exceptions, 1);
+    PyErr_NormalizeException(&type, value, traceback);
+    return type;
+}
+
+// The full "Traceback (most recent call last): ..." text for an exception
+// from python3_fetch_exception. Only called when Raku code reads it.
+PyObject* python3_format_exception(PyObject *type, PyObject *value, PyObject *traceback) {
+    PY3_GIL;
     PyObject *tb_module = PyImport_ImportModule("traceback");
-    if (tb_module) {
-        PyObject *format_func = PyObject_GetAttrString(tb_module, "format_exception");
-        if (format_func) {
-            PyObject *args = PyTuple_Pack(3, 
-                error->type ? error->type : Py_None,
-                error->value ? error->value : Py_None, 
-                error->traceback ? error->traceback : Py_None);
-            
-            PyObject *tb_list = PyObject_CallObject(format_func, args);
-            if (tb_list) {
-                PyObject *tb_str = PyUnicode_Join(PyUnicode_FromString(""), tb_list);
-                if (tb_str) {
-                    error->formatted_exception = strdup(PyUnicode_AsUTF8(tb_str));
-                    Py_DECREF(tb_str);
-                }
-                Py_DECREF(tb_list);
-            }
-            Py_DECREF(args);
-            Py_DECREF(format_func);
+    if (!tb_module) {
+        PyErr_Clear();
+        return NULL;
+    }
+
+    PyObject *lines = PyObject_CallMethod(tb_module, "format_exception", "OOO",
+        type, value ? value : Py_None, traceback ? traceback : Py_None);
+    Py_DECREF(tb_module);
+
+    PyObject *text = NULL;
+    if (lines) {
+        PyObject *empty = PyUnicode_FromString("");
+        if (empty) {
+            text = PyUnicode_Join(empty, lines);
+            Py_DECREF(empty);
         }
-        Py_DECREF(tb_module);
+        Py_DECREF(lines);
     }
+    if (!text) PyErr_Clear();
+    return text;
 }
 
 // Type checking functions
 int python3_is_none(PyObject *obj) {
+    PY3_GIL;
     return obj == Py_None;
 }
 
 int python3_is_bool(PyObject *obj) {
+    PY3_GIL;
     return PyBool_Check(obj);
 }
 
 int python3_is_int(PyObject *obj) {
+    PY3_GIL;
     return PyLong_Check(obj);
 }
 
 int python3_is_float(PyObject *obj) {
+    PY3_GIL;
     return PyFloat_Check(obj);
 }
 
 int python3_is_str(PyObject *obj) {
+    PY3_GIL;
     return PyUnicode_Check(obj);
 }
 
 int python3_is_bytes(PyObject *obj) {
+    PY3_GIL;
     return PyBytes_Check(obj);
 }
 
 int python3_is_list(PyObject *obj) {
+    PY3_GIL;
     return PyList_Check(obj);
 }
 
 int python3_is_tuple(PyObject *obj) {
+    PY3_GIL;
     return PyTuple_Check(obj);
 }
 
 int python3_is_dict(PyObject *obj) {
+    PY3_GIL;
     return PyDict_Check(obj);
 }
 
 int python3_is_set(PyObject *obj) {
+    PY3_GIL;
     return PySet_Check(obj);
 }
 
 int python3_is_callable(PyObject *obj) {
+    PY3_GIL;
     return PyCallable_Check(obj);
 }
 
 int python3_is_module(PyObject *obj) {
+    PY3_GIL;
     return PyModule_Check(obj);
 }
 
 int python3_is_type(PyObject *obj) {
+    PY3_GIL;
     return PyType_Check(obj);
 }
 
 // Conversion functions
-long python3_int_to_long(PyObject *obj) {
-    return PyLong_AsLong(obj);
+int64_t python3_int_to_long(PyObject *obj) {
+    PY3_GIL;
+    return PyLong_AsLongLong(obj);
+}
+
+// Digits of an int of any size, as "0x..." or "-0x..."; power-of-two bases
+// are exempt from the int/str digit limit of 3.11+
+PyObject* python3_int_to_hex(PyObject *obj) {
+    PY3_GIL;
+    return PyNumber_ToBase(obj, 16);
 }
 
 double python3_float_to_double(PyObject *obj) {
+    PY3_GIL;
     return PyFloat_AsDouble(obj);
 }
 
 int python3_bool_to_int(PyObject *obj) {
+    PY3_GIL;
     return obj == Py_True ? 1 : 0;
 }
 
 const char* python3_str_to_utf8(PyObject *obj, Py_ssize_t *size) {
-    return PyUnicode_AsUTF8AndSize(obj, size);
+    PY3_GIL;
+    const char *data = PyUnicode_AsUTF8AndSize(obj, size);
+    if (data) PY3_COUNT(bytes_from_python, *size);
+    return data;
 }
 
 const char* python3_bytes_to_buf(PyObject *obj, Py_ssize_t *size) {
+    PY3_GIL;
     char *buffer;
     if (PyBytes_AsStringAndSize(obj, &buffer, size) == -1) {
         return NULL;
     }
+    PY3_COUNT(bytes_from_python, *size);
     return buffer;
 }
 
 // Object creation functions
 PyObject* python3_none() {
+    PY3_GIL;
     Py_RETURN_NONE;
 }
 
 PyObject* python3_bool_from_int(int value) {
+    PY3_GIL;
     return PyBool_FromLong(value);
 }
 
-PyObject* python3_int_from_long(long value) {
-    return PyLong_FromLong(value);
+PyObject* python3_int_from_long(int64_t value) {
+    PY3_GIL;
+    return PyLong_FromLongLong(value);
+}
+
+// Ints that don't fit in 64 bits, from their digits in the given base
+PyObject* python3_int_from_string(const char *digits, int base) {
+    PY3_GIL;
+    return PyLong_FromString(digits, NULL, base);
 }
 
 PyObject* python3_float_from_double(double value) {
+    PY3_GIL;
     return PyFloat_FromDouble(value);
 }
 
 PyObject* python3_str_from_utf8(const char *str, Py_ssize_t size) {
+    PY3_GIL;
+    PY3_COUNT(bytes_to_python, size);
     return PyUnicode_FromStringAndSize(str, size);
 }
 
 PyObject* python3_bytes_from_buffer(const char *buf, Py_ssize_t size) {
+    PY3_GIL;
+    PY3_COUNT(bytes_to_python, size);
     return PyBytes_FromStringAndSize(buf, size);
 }
 
 // Collection functions
 PyObject* python3_list_new(Py_ssize_t size) {
+    PY3_GIL;
     return PyList_New(size);
 }
 
 int python3_list_set_item(PyObject *list, Py_ssize_t index, PyObject *item) {
-    return PyList_SetItem(list, index, item);
+    PY3_GIL;
+    return PyList_SetItem(list, index, py3_own(item));
 }
 
 PyObject* python3_list_get_item(PyObject *list, Py_ssize_t index) {
+    PY3_GIL;
     return PyList_GetItem(list, index);
 }
 
 Py_ssize_t python3_list_size(PyObject *list) {
+    PY3_GIL;
     return PyList_Size(list);
 }
 
 PyObject* python3_tuple_new(Py_ssize_t size) {
+    PY3_GIL;
     return PyTuple_New(size);
 }
 
 int python3_tuple_set_item(PyObject *tuple, Py_ssize_t index, PyObject *item) {
-    return PyTuple_SetItem(tuple, index, item);
+    PY3_GIL;
+    return PyTuple_SetItem(tuple, index, py3_own(item));
 }
 
 PyObject* python3_tuple_get_item(PyObject *tuple, Py_ssize_t index) {
+    PY3_GIL;
     return PyTuple_GetItem(tuple, index);
 }
 
 Py_ssize_t python3_tuple_size(PyObject *tuple) {
+    PY3_GIL;
     return PyTuple_Size(tuple);
 }
 
 PyObject* python3_dict_new() {
+    PY3_GIL;
     return PyDict_New();
 }
 
 int python3_dict_set_item(PyObject *dict, PyObject *key, PyObject *value) {
+    PY3_GIL;
     return PyDict_SetItem(dict, key, value);
 }
 
+// Like python3_dict_set_item, but takes over the key and value references,
+// as the list and tuple setters do
+int python3_dict_set_item_steal(PyObject *dict, PyObject *key, PyObject *value) {
+    PY3_GIL;
+    int status = key && value ? PyDict_SetItem(dict, key, value) : -1;
+    py3_release(key);
+    py3_release(value);
+    return status;
+}
+
 PyObject* python3_dict_get_item(PyObject *dict, PyObject *key) {
+    PY3_GIL;
     return PyDict_GetItem(dict, key);
 }
 
 PyObject* python3_dict_keys(PyObject *dict) {
+    PY3_GIL;
     return PyDict_Keys(dict);
 }
 
 PyObject* python3_dict_values(PyObject *dict) {
+    PY3_GIL;
     return PyDict_Values(dict);
 }
 
 PyObject* python3_dict_items(PyObject *dict) {
+    PY3_GIL;
     return PyDict_Items(dict);
 }
 
 Py_ssize_t python3_dict_size(PyObject *dict) {
+    PY3_GIL;
     return PyDict_Size(dict);
 }
 
 // Object operations
 PyObject* python3_get_attr(PyObject *obj, const char *name) {
+    PY3_GIL;
     return PyObject_GetAttrString(obj, name);
 }
 
 int python3_set_attr(PyObject *obj, const char *name, PyObject *value) {
+    PY3_GIL;
     return PyObject_SetAttrString(obj, name, value);
 }
 
 int python3_has_attr(PyObject *obj, const char *name) {
+    PY3_GIL;
     return PyObject_HasAttrString(obj, name);
 }
 
 PyObject* python3_dir(PyObject *obj) {
+    PY3_GIL;
     return PyObject_Dir(obj);
 }
 
 PyObject* python3_type(PyObject *obj) {
+    PY3_GIL;
     return PyObject_Type(obj);
 }
 
 PyObject* python3_str(PyObject *obj) {
+    PY3_GIL;
     return PyObject_Str(obj);
 }
 
 PyObject* python3_repr(PyObject *obj) {
+    PY3_GIL;
     return PyObject_Repr(obj);
 }
 
 // Import and execution
 PyObject* python3_import(const char *name) {
+    PY3_GIL;
     return PyImport_ImportModule(name);
 }
 
 PyObject* python3_import_from(const char *module, const char *name) {
+    PY3_GIL;
     PyObject *mod = PyImport_ImportModule(module);
     if (!mod) return NULL;
     
@@ -302,7 +863,166 @@ PyObject* python3_import_from(const char *module, const char *name) {
     return obj;
 }
 
+// ===== COMPILED CODE CACHE =====
+// run() tends to execute the same short snippets over and over, so compiled
+// code objects are kept in a bounded LRU cache keyed by source and mode.
+// The cache belongs to the main interpreter and is protected by its GIL;
+// code running in pool sub-interpreters is compiled every time.
+
+#define PY3_CODE_CACHE_SIZE 256
+#define PY3_CODE_CACHE_BUCKETS 512
+
+// Links are entry index + 1 so that 0 means "none" and the static
+// zero-initialized tables start out empty
+typedef struct {
+    uint64_t hash;
+    int mode;
+    char *source;
+    size_t length;
+    PyObject *code;
+    int prev, next;   // LRU list, most recently used first
+    int chain;        // next entry in the same bucket
+} CodeCacheEntry;
+
+static CodeCacheEntry code_cache[PY3_CODE_CACHE_SIZE];
+static int code_buckets[PY3_CODE_CACHE_BUCKETS];
+static int code_lru_head = 0, code_lru_tail = 0;
+static int code_cache_used = 0;
+static uint64_t code_cache_hits = 0, code_cache_misses = 0;
+
+static uint64_t code_hash(const char *source, size_t length, int mode) {
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ULL ^ (uint64_t)mode;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)source[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static void code_lru_unlink(int link) {
+    CodeCacheEntry *e = &code_cache[link - 1];
+    if (e->prev) code_cache[e->prev - 1].next = e->next; else code_lru_head = e->next;
+    if (e->next) code_cache[e->next - 1].prev = e->prev; else code_lru_tail = e->prev;
+    e->prev = e->next = 0;
+}
+
+static void code_lru_push_front(int link) {
+    CodeCacheEntry *e = &code_cache[link - 1];
+    e->prev = 0;
+    e->next = code_lru_head;
+    if (code_lru_head) code_cache[code_lru_head - 1].prev = link;
+    code_lru_head = link;
+    if (!code_lru_tail) code_lru_tail = link;
+}
+
+static void code_cache_evict(int link) {
+    CodeCacheEntry *e = &code_cache[link - 1];
+    int *slot = &code_buckets[e->hash % PY3_CODE_CACHE_BUCKETS];
+    while (*slot != link) slot = &code_cache[*slot - 1].chain;
+    *slot = e->chain;
+
+    code_lru_unlink(link);
+    Py_CLEAR(e->code);
+    free(e->source);
+    memset(e, 0, sizeof(*e));
+}
+
+static void code_cache_clear(void) {
+    while (code_lru_head) code_cache_evict(code_lru_head);
+    code_cache_used = 0;
+}
+
+static int in_main_interpreter(void) {
+    return PyThreadState_Get()->interp == PyInterpreterState_Main();
+}
+
+// Compile source, returning a new reference to the (possibly cached) code
+// object. mode is Py_eval_input or Py_file_input.
+static PyObject* compile_cached(const char *source, int mode) {
+    if (!in_main_interpreter()) {
+        return Py_CompileString(source, "<string>", mode);
+    }
+
+    size_t length = strlen(source);
+    uint64_t hash = code_hash(source, length, mode);
+    int *bucket = &code_buckets[hash % PY3_CODE_CACHE_BUCKETS];
+
+    for (int link = *bucket; link; link = code_cache[link - 1].chain) {
+        CodeCacheEntry *e = &code_cache[link - 1];
+        if (e->hash == hash && e->mode == mode && e->length == length &&
+            memcmp(e->source, source, length) == 0) {
+            code_cache_hits++;
+            if (code_lru_head != link) {
+                code_lru_unlink(link);
+                code_lru_push_front(link);
+            }
+            Py_INCREF(e->code);
+            return e->code;
+        }
+    }
+
+    code_cache_misses++;
+    PyObject *code = Py_CompileString(source, "<string>", mode);
+    if (!code) return NULL;
+
+    char *copy = malloc(length + 1);
+    if (!copy) return code;  // Still usable, just not cached
+    memcpy(copy, source, length + 1);
+
+    int link;
+    if (code_cache_used < PY3_CODE_CACHE_SIZE) {
+        link = ++code_cache_used;
+    } else {
+        link = code_lru_tail;
+        code_cache_evict(link);
+    }
+
+    CodeCacheEntry *e = &code_cache[link - 1];
+    e->hash = hash;
+    e->mode = mode;
+    e->source = copy;
+    e->length = length;
+    e->code = code;
+    Py_INCREF(code);
+    e->chain = *bucket;
+    *bucket = link;
+    code_lru_push_front(link);
+
+    return code;
+}
+
+static PyObject* run_cached(const char *code, int mode, PyObject *globals, PyObject *locals) {
+    PyObject *compiled = compile_cached(code, mode);
+    if (!compiled) return NULL;
+
+    PyObject *result = PyEval_EvalCode(compiled, globals, locals);
+    Py_DECREF(compiled);
+    return result;
+}
+
+// Compile code for repeated evaluation with python3_eval_code.
+// is_eval selects expression mode, like run(:eval).
+PyObject* python3_compile(const char *code, int is_eval) {
+    PY3_GIL;
+    return compile_cached(code, is_eval ? Py_eval_input : Py_file_input);
+}
+
+PyObject* python3_eval_code(PyObject *code, PyObject *globals, PyObject *locals) {
+    PY3_GIL;
+    if (!PyCode_Check(code)) {
+        PyErr_Format(PyExc_TypeError, "expected a code object, not '%.200s'",
+                     Py_TYPE(code)->tp_name);
+        return NULL;
+    }
+    if (!locals) {
+        locals = globals;
+    }
+    return PyEval_EvalCode(code, globals, locals);
+}
+
 PyObject* python3_eval(const char *code, PyObject *globals, PyObject *locals) {
+    PY3_GIL;
     if (!globals) {
         globals = PyDict_New();
     }
@@ -310,10 +1030,11 @@ PyObject* python3_eval(const char *code, PyObject *globals, PyObject *locals) {
         locals = globals;
     }
     
-    return PyRun_String(code, Py_eval_input, globals, locals);
+    return run_cached(code, Py_eval_input, globals, locals);
 }
 
 PyObject* python3_exec(const char *code, PyObject *globals, PyObject *locals) {
+    PY3_GIL;
     if (!globals) {
         globals = PyDict_New();
     }
@@ -321,11 +1042,12 @@ PyObject* python3_exec(const char *code, PyObject *globals, PyObject *locals) {
         locals = globals;
     }
     
-    return PyRun_String(code, Py_file_input, globals, locals);
+    return run_cached(code, Py_file_input, globals, locals);
 }
 
 // Function calling with better argument handling
 PyObject* python3_call(PyObject *callable, PyObject *args, PyObject *kwargs) {
+    PY3_GIL;
     if (!args) {
         args = PyTuple_New(0);
     }
@@ -335,6 +1057,7 @@ PyObject* python3_call(PyObject *callable, PyObject *args, PyObject *kwargs) {
 }
 
 PyObject* python3_call_method(PyObject *obj, const char *method, PyObject *args, PyObject *kwargs) {
+    PY3_GIL;
     PyObject *meth = PyObject_GetAttrString(obj, method);
     if (!meth) return NULL;
     
@@ -347,115 +1070,788 @@ PyObject* python3_call_method(PyObject *obj, const char *method, PyObject *args,
     return result;
 }
 
-// Reference counting
-void python3_inc_ref(PyObject *obj) {
-    Py_XINCREF(obj);
-}
+// Vectorcall entry points
+// args holds the positional arguments followed by one value per name in
+// kwnames. Both the argument references and kwnames are stolen, so the
+// caller can hand over freshly converted objects without a second pass
+// to release them.
+#if PY_VERSION_HEX < 0x03090000
+#define PyObject_Vectorcall _PyObject_Vectorcall
+#endif
 
-void python3_dec_ref(PyObject *obj) {
-    Py_XDECREF(obj);
+static void release_vector(PyObject **args, Py_ssize_t count, PyObject *kwnames) {
+    for (Py_ssize_t i = 0; i < count; i++) {
+        py3_release(args[i]);
+    }
+    Py_XDECREF(kwnames);
 }
 
-Py_ssize_t python3_ref_count(PyObject *obj) {
-    return Py_REFCNT(obj);
+static Py_ssize_t vector_length(Py_ssize_t nargs, PyObject *kwnames) {
+    return nargs + (kwnames ? PyTuple_GET_SIZE(kwnames) : 0);
 }
 
-// Raku object wrapper
+// ===== METHOD RESOLUTION CACHE =====
+// obj.<name> from Raku is resolved against the type once per (type, version
+// tag, interned name). CPython gives a type a new version tag whenever it
+// or one of its bases is modified, so stale entries simply stop matching.
+// Like the code cache this is only used from the main interpreter.
+
+#define PY3_METHOD_CACHE_SIZE 1024  // Power of two
+
 typedef struct {
-    PyObject_HEAD
-    int raku_index;
-} RakuObject;
+    PyTypeObject *type;
+    unsigned int version;
+    PyObject *name;   // Interned; strong reference
+    PyObject *descr;  // _PyType_Lookup result or NULL; strong reference
+} MethodCacheEntry;
+
+static MethodCacheEntry method_cache[PY3_METHOD_CACHE_SIZE];
+static uint64_t method_cache_hits = 0, method_cache_misses = 0;
+
+// How resolve_attr() answered
+enum {
+    PY3_RESOLVE_GENERIC = 1,  // Not cacheable here; use the regular C API
+    PY3_RESOLVE_UNBOUND,      // Function to call with obj as first argument
+    PY3_RESOLVE_VALUE         // The attribute value itself
+};
 
-static PyObject* raku_object_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
-    RakuObject *self = (RakuObject *)type->tp_alloc(type, 0);
-    if (self != NULL) {
-        self->raku_index = -1;
+static int type_version_valid(PyTypeObject *type) {
+#if PY_VERSION_HEX >= 0x030D0000
+    // 3.13 dropped the flag; a zero tag means "no valid version"
+    return type->tp_version_tag != 0;
+#else
+    return PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG) && type->tp_version_tag != 0;
+#endif
+}
+
+// Borrowed reference to the attribute of type (or NULL), from the cache
+// while the type is unchanged. *cached tells whether the entry was there.
+static PyObject* lookup_type_attr(PyTypeObject *type, PyObject *name, int *cached) {
+    size_t slot = (((uintptr_t)type >> 4) ^ ((uintptr_t)name >> 4)) & (PY3_METHOD_CACHE_SIZE - 1);
+    MethodCacheEntry *e = &method_cache[slot];
+
+    *cached = e->type == type && e->name == name && e->version == type->tp_version_tag &&
+              type_version_valid(type);
+    if (*cached) return e->descr;
+
+    PyObject *descr = _PyType_Lookup(type, name);  // Assigns a version tag
+    if (!type_version_valid(type)) return descr;
+
+    // Fill in the entry before releasing the old references, which may run
+    // arbitrary code
+    PyObject *old_name = e->name, *old_descr = e->descr;
+    Py_INCREF(name);
+    Py_XINCREF(descr);
+    e->type = type;
+    e->version = type->tp_version_tag;
+    e->name = name;
+    e->descr = descr;
+    Py_XDECREF(old_name);
+    Py_XDECREF(old_descr);
+
+    return descr;
+}
+
+// Instance dict lookup: 0 when absent, PY3_RESOLVE_VALUE with a new
+// reference in *out, PY3_RESOLVE_GENERIC when it can't be checked cheaply
+// or -1 on error
+static int lookup_instance_attr(PyObject *obj, PyObject *name, PyObject **out) {
+    PyTypeObject *type = Py_TYPE(obj);
+
+#ifdef Py_TPFLAGS_MANAGED_DICT
+    // Inline instance values (3.11+) can only be probed through a dict, and
+    // making one would take the object off CPython's fast attribute paths
+    if (PyType_HasFeature(type, Py_TPFLAGS_MANAGED_DICT)) return PY3_RESOLVE_GENERIC;
+#endif
+    if (type->tp_dictoffset == 0) return 0;
+
+    PyObject **dictptr = _PyObject_GetDictPtr(obj);
+    if (!dictptr || !*dictptr) return 0;
+
+    PyObject *value = PyDict_GetItemWithError(*dictptr, name);
+    if (value) {
+        Py_INCREF(value);
+        *out = value;
+        return PY3_RESOLVE_VALUE;
     }
-    return (PyObject *)self;
+    return PyErr_Occurred() ? -1 : 0;
 }
 
-static int raku_object_init(RakuObject *self, PyObject *args, PyObject *kwds) {
-    if (!PyArg_ParseTuple(args, "i", &self->raku_index)) {
-        return -1;
+// Body of resolve_attr; *cached tells whether the type cache answered
+static int resolve_attr_kind(PyObject *obj, PyObject *name, PyObject **out, int *cached) {
+    PyTypeObject *type = Py_TYPE(obj);
+    *out = NULL;
+
+    if (type->tp_getattro != PyObject_GenericGetAttr || !PyUnicode_CheckExact(name) ||
+        !in_main_interpreter()) {
+        return PY3_RESOLVE_GENERIC;
     }
-    return 0;
-}
 
-static PyObject* raku_object_call(RakuObject *self, PyObject *args, PyObject *kwds) {
-    PyObject *error = NULL;
-    PyObject *result = raku_callbacks.call_raku_object(self->raku_index, args, &error);
-    
-    if (error) {
-        PyErr_SetObject(PyExc_RuntimeError, error);
-        Py_DECREF(error);
-        return NULL;
+    PyObject *descr = lookup_type_attr(type, name, cached);
+    descrgetfunc get = NULL;
+    if (descr) {
+        Py_INCREF(descr);
+        get = Py_TYPE(descr)->tp_descr_get;
+
+        // Data descriptors (properties, slots) take precedence over the instance
+        if (get && Py_TYPE(descr)->tp_descr_set) {
+            *out = get(descr, obj, (PyObject *)type);
+            Py_DECREF(descr);
+            return *out ? PY3_RESOLVE_VALUE : -1;
+        }
     }
-    
-    return result;
-}
 
-static PyObject* raku_object_getattr(RakuObject *self, char *name) {
-    // First check if it's a special attribute
-    if (strcmp(name, "__dict__") == 0 || strcmp(name, "__class__") == 0) {
-        return PyObject_GenericGetAttr((PyObject *)self, PyUnicode_FromString(name));
+    int found = lookup_instance_attr(obj, name, out);
+    if (found != 0) {
+        Py_XDECREF(descr);
+        return found;
     }
-    
-    // Otherwise delegate to Raku
-    PyObject *error = NULL;
-    PyObject *args = PyTuple_Pack(1, PyUnicode_FromString(name));
-    PyObject *result = raku_callbacks.call_raku_method(self->raku_index, "__getattr__", args, &error);
-    Py_DECREF(args);
-    
-    if (error) {
-        PyErr_SetObject(PyExc_AttributeError, error);
-        Py_DECREF(error);
-        return NULL;
+
+    // Missing attributes go the generic way so CPython raises the error
+    if (!descr) return PY3_RESOLVE_GENERIC;
+
+    if (PyType_HasFeature(Py_TYPE(descr), Py_TPFLAGS_METHOD_DESCRIPTOR)) {
+        *out = descr;
+        return PY3_RESOLVE_UNBOUND;
     }
-    
-    return result;
+    if (get) {
+        *out = get(descr, obj, (PyObject *)type);
+        Py_DECREF(descr);
+        return *out ? PY3_RESOLVE_VALUE : -1;
+    }
+
+    *out = descr;
+    return PY3_RESOLVE_VALUE;
+}
+
+// Resolve obj.<name> following PyObject_GenericGetAttr's rules, without
+// binding methods. Returns a PY3_RESOLVE_* kind with a new reference in
+// *out for UNBOUND and VALUE, or -1 on error. Only lookups answered here
+// count as cache hits or misses; GENERIC ones are looked up again by the
+// caller.
+static int resolve_attr(PyObject *obj, PyObject *name, PyObject **out) {
+    int cached = 0;
+    int kind = resolve_attr_kind(obj, name, out, &cached);
+    if (kind == PY3_RESOLVE_UNBOUND || kind == PY3_RESOLVE_VALUE) {
+        if (cached) method_cache_hits++;
+        else method_cache_misses++;
+    }
+    return kind;
 }
 
-static PyTypeObject RakuObjectType = {
-    PyVarObject_HEAD_INIT(NULL, 0)
-    .tp_name = "python3.RakuObject",
-    .tp_doc = "Raku object wrapper",
-    .tp_basicsize = sizeof(RakuObject),
-    .tp_itemsize = 0,
-    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
-    .tp_new = raku_object_new,
-    .tp_init = (initproc)raku_object_init,
-    .tp_call = (ternaryfunc)raku_object_call,
-    .tp_getattro = (getattrofunc)raku_object_getattr,
-};
+static void method_cache_clear(void) {
+    for (size_t i = 0; i < PY3_METHOD_CACHE_SIZE; i++) {
+        MethodCacheEntry *e = &method_cache[i];
+        PyObject *name = e->name, *descr = e->descr;
+        memset(e, 0, sizeof(*e));
+        Py_XDECREF(name);
+        Py_XDECREF(descr);
+    }
+}
 
-// Module methods
-static PyObject* python3_call_raku(PyObject *self, PyObject *args) {
-    int index;
-    PyObject *params;
-    
-    if (!PyArg_ParseTuple(args, "iO", &index, &params)) {
-        return NULL;
+PyObject* python3_intern(const char *name) {
+    PY3_GIL;
+    return PyUnicode_InternFromString(name);
+}
+
+// Build a kwnames tuple of interned strings in one call
+PyObject* python3_kwnames(const char **names, Py_ssize_t count) {
+    PY3_GIL;
+    PyObject *tuple = PyTuple_New(count);
+    if (!tuple) return NULL;
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        PyObject *name = PyUnicode_InternFromString(names[i]);
+        if (!name) {
+            Py_DECREF(tuple);
+            return NULL;
+        }
+        PyTuple_SET_ITEM(tuple, i, name);
     }
-    
-    PyObject *error = NULL;
-    PyObject *result = raku_callbacks.call_raku_object(index, params, &error);
-    
-    if (error) {
-        PyErr_SetObject(PyExc_RuntimeError, error);
-        Py_DECREF(error);
-        return NULL;
+
+    return tuple;
+}
+
+PyObject* python3_vectorcall(PyObject *callable, PyObject **args, Py_ssize_t nargs, PyObject *kwnames) {
+    PY3_GIL;
+    PyObject *result = PyObject_Vectorcall(callable, args, nargs, kwnames);
+    release_vector(args, vector_length(nargs, kwnames), kwnames);
+    return result;
+}
+
+// Call obj.<name>(*args) without building a tuple or bound method.
+// args[0] is reserved for the receiver and filled in here; the arguments
+// proper start at args[1] and nargs does not count the receiver.
+PyObject* python3_vectorcall_method(PyObject *obj, PyObject *name, PyObject **args, Py_ssize_t nargs, PyObject *kwnames) {
+    PY3_GIL;
+    Py_ssize_t count = vector_length(nargs, kwnames);
+    PyObject *result = NULL;
+    PyObject *callable;
+
+    switch (resolve_attr(obj, name, &callable)) {
+    case PY3_RESOLVE_UNBOUND:
+        args[0] = obj;
+        result = PyObject_Vectorcall(callable, args, nargs + 1, kwnames);
+        Py_DECREF(callable);
+        break;
+    case PY3_RESOLVE_VALUE:
+        result = PyObject_Vectorcall(callable, args + 1, nargs | PY_VECTORCALL_ARGUMENTS_OFFSET, kwnames);
+        Py_DECREF(callable);
+        break;
+    case PY3_RESOLVE_GENERIC:
+#if PY_VERSION_HEX >= 0x03090000
+        args[0] = obj;
+        result = PyObject_VectorcallMethod(name, args, nargs + 1, kwnames);
+#else
+        callable = PyObject_GetAttr(obj, name);
+        result = callable ? PyObject_Vectorcall(callable, args + 1, nargs, kwnames) : NULL;
+        Py_XDECREF(callable);
+#endif
+        break;
     }
-    
+
+    args[0] = NULL;
+    release_vector(args + 1, count, kwnames);
     return result;
 }
 
-static PyObject* python3_invoke_raku(PyObject *self, PyObject *args) {
-    int index;
-    const char *method;
-    PyObject *params;
-    
-    if (!PyArg_ParseTuple(args, "isO", &index, &method, &params)) {
-        return NULL;
+// Attribute access that calls the attribute when it is callable, so a
+// no-argument method call and a plain attribute read are one transition
+PyObject* python3_get_attr_or_call(PyObject *obj, PyObject *name) {
+    PY3_GIL;
+    PyObject *attr;
+    PyObject *result;
+
+    switch (resolve_attr(obj, name, &attr)) {
+    case PY3_RESOLVE_UNBOUND:
+        result = PyObject_Vectorcall(attr, &obj, 1, NULL);
+        Py_DECREF(attr);
+        return result;
+    case PY3_RESOLVE_GENERIC:
+        attr = PyObject_GetAttr(obj, name);
+        break;
+    }
+    if (!attr || !PyCallable_Check(attr)) return attr;
+
+    result = PyObject_Vectorcall(attr, NULL, 0, NULL);
+    Py_DECREF(attr);
+    return result;
+}
+
+// Reference counting
+void python3_inc_ref(PyObject *obj) {
+    PY3_GIL;
+    Py_XINCREF(obj);
+}
+
+void python3_dec_ref(PyObject *obj) {
+    PY3_GIL;
+    py3_release(obj);
+}
+
+Py_ssize_t python3_ref_count(PyObject *obj) {
+    PY3_GIL;
+    return Py_REFCNT(obj);
+}
+
+// ===== TYPE HANDLES =====
+// Raku wrappers keep per-type data under a small integer handle instead of
+// the type's name. The handle comes from a table keyed by the address of
+// the type object. Heap types are watched through a weak reference, and
+// their entry is dropped when they die, so a new type that reuses the
+// address gets a new handle. Handles are never reused.
+
+typedef struct {
+    PyTypeObject *type;  // NULL when empty
+    PyObject *weakref;   // Heap types only; NULL for static types
+    int64_t handle;
+} TypeHandleEntry;
+
+#define PY3_TYPE_TOMBSTONE ((PyTypeObject *)1)
+
+static TypeHandleEntry *type_handles = NULL;
+static size_t type_handles_cap = 0;   // Power of two
+static size_t type_handles_used = 0;  // Including tombstones
+static int64_t type_handles_next = 0;
+static PyObject *type_handle_callback = NULL;
+
+static size_t type_handle_slot(PyTypeObject *type) {
+    return (size_t)(((uintptr_t)type >> 4) * 0x9E3779B97F4A7C15ULL) & (type_handles_cap - 1);
+}
+
+static int type_handles_grow(void) {
+    size_t cap = type_handles_cap ? type_handles_cap * 2 : 256;
+    TypeHandleEntry *table = calloc(cap, sizeof(TypeHandleEntry));
+    if (!table) return -1;
+
+    TypeHandleEntry *old = type_handles;
+    size_t old_cap = type_handles_cap;
+    type_handles = table;
+    type_handles_cap = cap;
+    type_handles_used = 0;
+    for (size_t i = 0; i < old_cap; i++) {
+        if (!old[i].type || old[i].type == PY3_TYPE_TOMBSTONE) continue;
+        size_t slot = type_handle_slot(old[i].type);
+        while (type_handles[slot].type) slot = (slot + 1) & (cap - 1);
+        type_handles[slot] = old[i];
+        type_handles_used++;
+    }
+    free(old);
+    return 0;
+}
+
+// Weak reference callback of a heap type that is being destroyed
+static PyObject* type_handle_dead(PyObject *self, PyObject *weakref) {
+    for (size_t i = 0; i < type_handles_cap; i++) {
+        if (type_handles[i].weakref == weakref) {
+            type_handles[i].type = PY3_TYPE_TOMBSTONE;
+            type_handles[i].weakref = NULL;
+            Py_DECREF(weakref);
+            break;
+        }
+    }
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef type_handle_dead_def = {"type_handle_dead", type_handle_dead, METH_O, NULL};
+
+// -1 when the type could not be recorded; the caller then keeps its data
+// unshared
+static int64_t type_handle(PyTypeObject *type) {
+    size_t slot = 0, free_slot = (size_t)-1;
+    if (type_handles_cap) {
+        for (slot = type_handle_slot(type); type_handles[slot].type; slot = (slot + 1) & (type_handles_cap - 1)) {
+            if (type_handles[slot].type == type) return type_handles[slot].handle;
+            if (type_handles[slot].type == PY3_TYPE_TOMBSTONE && free_slot == (size_t)-1) free_slot = slot;
+        }
+    }
+
+    PyObject *weakref = NULL;
+    if (PyType_HasFeature(type, Py_TPFLAGS_HEAPTYPE)) {
+        if (!type_handle_callback &&
+            !(type_handle_callback = PyCFunction_New(&type_handle_dead_def, NULL))) {
+            PyErr_Clear();
+            return -1;
+        }
+        if (!(weakref = PyWeakref_NewRef((PyObject *)type, type_handle_callback))) {
+            PyErr_Clear();
+            return -1;
+        }
+    }
+
+    if (free_slot == (size_t)-1) {
+        if ((type_handles_used + 1) * 2 > type_handles_cap) {
+            if (type_handles_grow() < 0) {
+                Py_XDECREF(weakref);
+                return -1;
+            }
+        }
+        for (slot = type_handle_slot(type); type_handles[slot].type; slot = (slot + 1) & (type_handles_cap - 1));
+        type_handles_used++;
+        free_slot = slot;
+    }
+
+    type_handles[free_slot].type = type;
+    type_handles[free_slot].weakref = weakref;
+    type_handles[free_slot].handle = type_handles_next++;
+    return type_handles[free_slot].handle;
+}
+
+// Take a reference for a new Raku wrapper and return its type's handle
+int64_t python3_wrap_object(PyObject *obj) {
+    PY3_GIL;
+    __atomic_fetch_add(&instrument.wrappers_created, 1, __ATOMIC_RELAXED);
+    Py_INCREF(obj);
+    return type_handle(Py_TYPE(obj));
+}
+
+// Drop the reference of a garbage collected wrapper
+void python3_unwrap_object(PyObject *obj) {
+    PY3_GIL;
+    __atomic_fetch_add(&instrument.wrappers_released, 1, __ATOMIC_RELAXED);
+    Py_DECREF(obj);
+}
+
+// Name of the object's type, e.g. "int" or "collections.OrderedDict"
+const char* python3_type_name(PyObject *obj) {
+    PY3_GIL;
+    return Py_TYPE(obj)->tp_name;
+}
+
+// ===== RAKU OBJECTS =====
+// Raku callables and objects handed to Python. Calls use vectorcall, so
+// the Raku side receives the raw argument vector instead of a tuple it has
+// to convert as a whole. Attribute access returns a bound method object
+// that is created once per name and cached on the object.
+
+#ifndef Py_TPFLAGS_HAVE_VECTORCALL
+#define Py_TPFLAGS_HAVE_VECTORCALL _Py_TPFLAGS_HAVE_VECTORCALL
+#endif
+
+// Registered separately from RakuCallbacks, which is passed by value and
+// so cannot grow without breaking existing callers
+typedef struct {
+    PyObject *(*call_raku_vector)(int, const char *, PyObject *const *, Py_ssize_t, PyObject *, PyObject **);
+    PyObject *(*call_raku_batch)(int, PyObject *, PyObject **);
+} RakuVectorCallbacks;
+
+static RakuVectorCallbacks raku_vector_callbacks;
+
+void python3_set_vector_callbacks(PyObject *(*call_raku_vector)(int, const char *, PyObject *const *,
+                                                                Py_ssize_t, PyObject *, PyObject **),
+                                  PyObject *(*call_raku_batch)(int, PyObject *, PyObject **)) {
+    raku_vector_callbacks.call_raku_vector = call_raku_vector;
+    raku_vector_callbacks.call_raku_batch = call_raku_batch;
+}
+
+// Turn the outcome of a Raku callback into a new reference or an exception
+static PyObject* raku_callback_result(PyObject *result, PyObject *error) {
+    if (error) {
+        PyErr_SetObject(PyExc_RuntimeError, error);
+        py3_release(error);
+        return NULL;
+    }
+    if (!result && !PyErr_Occurred()) {
+        PyErr_SetString(PyExc_RuntimeError, "Raku object is no longer registered");
+    }
+    return py3_own(result);
+}
+
+// name is NULL to call the object itself
+static PyObject* raku_vector_call(int index, const char *name, PyObject *const *args,
+                                  size_t nargsf, PyObject *kwnames) {
+    if (!raku_vector_callbacks.call_raku_vector) {
+        PyErr_SetString(PyExc_RuntimeError, "Raku callbacks are not registered");
+        return NULL;
+    }
+    PyObject *error = NULL;
+    PyObject *result = raku_vector_callbacks.call_raku_vector(index, name, args, PyVectorcall_NARGS(nargsf),
+                                                              kwnames, &error);
+    return raku_callback_result(result, error);
+}
+
+typedef struct {
+    PyObject_HEAD
+    int raku_index;
+    int registered;       // index owned by this object, returned on dealloc
+    Py_ssize_t batch;     // items per callback for map(); 0 when not batched
+    vectorcallfunc vectorcall;
+} RakuObject;
+
+typedef struct {
+    PyObject_HEAD
+    RakuObject *owner;
+    PyObject *name;
+    const char *utf8;     // owned by name
+    vectorcallfunc vectorcall;
+} RakuMethod;
+
+static PyTypeObject RakuObjectType;
+static PyTypeObject RakuMethodType;
+static PyTypeObject RakuMapType;
+
+static PyObject* raku_object_vectorcall(PyObject *self, PyObject *const *args, size_t nargsf, PyObject *kwnames) {
+    return raku_vector_call(((RakuObject *)self)->raku_index, NULL, args, nargsf, kwnames);
+}
+
+static PyObject* raku_method_vectorcall(PyObject *self, PyObject *const *args, size_t nargsf, PyObject *kwnames) {
+    RakuMethod *method = (RakuMethod *)self;
+    // Cleared by the cycle collector while still referenced elsewhere
+    if (!method->owner) {
+        PyErr_SetString(PyExc_RuntimeError, "Raku method has lost its object");
+        return NULL;
+    }
+    return raku_vector_call(method->owner->raku_index, method->utf8, args, nargsf, kwnames);
+}
+
+static PyObject* raku_object_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    RakuObject *self = (RakuObject *)type->tp_alloc(type, 0);
+    if (self != NULL) {
+        self->raku_index = -1;
+        self->vectorcall = raku_object_vectorcall;
+    }
+    return (PyObject *)self;
+}
+
+static int raku_object_init(RakuObject *self, PyObject *args, PyObject *kwds) {
+    if (!PyArg_ParseTuple(args, "i|n", &self->raku_index, &self->batch)) {
+        return -1;
+    }
+    return 0;
+}
+
+// Registry slots of objects Python has dropped, for Raku to free. Like
+// the buffer handles below, the queue is protected by the GIL.
+static int *released_objects = NULL;
+static Py_ssize_t released_objects_count = 0;
+static Py_ssize_t released_objects_cap = 0;
+
+static void raku_object_dealloc(RakuObject *self) {
+    if (self->registered) {
+        if (released_objects_count == released_objects_cap) {
+            Py_ssize_t cap = released_objects_cap ? released_objects_cap * 2 : 64;
+            int *grown = realloc(released_objects, cap * sizeof(int));
+            if (grown) {
+                released_objects = grown;
+                released_objects_cap = cap;
+            }
+        }
+        // Without room the Raku object is simply kept for the rest of the process
+        if (released_objects_count < released_objects_cap) {
+            released_objects[released_objects_count++] = self->raku_index;
+        }
+    }
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject* raku_object_getattro(RakuObject *self, PyObject *name) {
+    if (!PyUnicode_Check(name)) {
+        return PyObject_GenericGetAttr((PyObject *)self, name);
+    }
+
+    // Dunder names and map() of batched objects belong to the type
+    Py_ssize_t len;
+    const char *utf8 = PyUnicode_AsUTF8AndSize(name, &len);
+    if (!utf8) return NULL;
+    if ((len > 4 && utf8[0] == '_' && utf8[1] == '_' && utf8[len - 1] == '_' && utf8[len - 2] == '_')
+        || (self->batch > 0 && strcmp(utf8, "map") == 0)) {
+        return PyObject_GenericGetAttr((PyObject *)self, name);
+    }
+
+    // A new method per access, like Python's bound methods. Caching it on
+    // self would make a reference cycle, and the object, with its registry
+    // slot, would then only be freed by the cycle collector. The UTF-8 name
+    // is cached by the str object itself.
+    RakuMethod *method = PyObject_GC_New(RakuMethod, &RakuMethodType);
+    if (!method) return NULL;
+    Py_INCREF(self);
+    Py_INCREF(name);
+    method->owner = self;
+    method->name = name;
+    method->utf8 = utf8;
+    method->vectorcall = raku_method_vectorcall;
+    PyObject_GC_Track(method);
+    return (PyObject *)method;
+}
+
+static PyObject* raku_object_map(RakuObject *self, PyObject *iterable);
+
+static PyMethodDef raku_object_methods[] = {
+    {"map", (PyCFunction)raku_object_map, METH_O,
+     "Apply a batched Raku callable to every item, one callback per chunk"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyTypeObject RakuObjectType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "python3.RakuObject",
+    .tp_doc = "Raku object wrapper",
+    .tp_basicsize = sizeof(RakuObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_VECTORCALL,
+    .tp_vectorcall_offset = offsetof(RakuObject, vectorcall),
+    .tp_new = raku_object_new,
+    .tp_init = (initproc)raku_object_init,
+    .tp_dealloc = (destructor)raku_object_dealloc,
+    .tp_call = PyVectorcall_Call,
+    .tp_getattro = (getattrofunc)raku_object_getattro,
+    .tp_methods = raku_object_methods,
+};
+
+static int raku_method_traverse(RakuMethod *self, visitproc visit, void *arg) {
+    Py_VISIT(self->owner);
+    return 0;
+}
+
+static int raku_method_clear(RakuMethod *self) {
+    Py_CLEAR(self->owner);
+    return 0;
+}
+
+static void raku_method_dealloc(RakuMethod *self) {
+    PyObject_GC_UnTrack(self);
+    raku_method_clear(self);
+    Py_XDECREF(self->name);
+    PyObject_GC_Del(self);
+}
+
+static PyTypeObject RakuMethodType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "python3.RakuMethod",
+    .tp_doc = "Method of a Raku object",
+    .tp_basicsize = sizeof(RakuMethod),
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC | Py_TPFLAGS_HAVE_VECTORCALL,
+    .tp_vectorcall_offset = offsetof(RakuMethod, vectorcall),
+    .tp_dealloc = (destructor)raku_method_dealloc,
+    .tp_traverse = (traverseproc)raku_method_traverse,
+    .tp_clear = (inquiry)raku_method_clear,
+    .tp_call = PyVectorcall_Call,
+};
+
+// Iterator returned by map(): pulls up to batch items from the source,
+// hands them to Raku as one list and yields the results one by one
+typedef struct {
+    PyObject_HEAD
+    RakuObject *func;
+    PyObject *source;
+    PyObject *results;
+    Py_ssize_t pos;
+} RakuMap;
+
+static PyObject* raku_object_map(RakuObject *self, PyObject *iterable) {
+    PyObject *source = PyObject_GetIter(iterable);
+    if (!source) return NULL;
+
+    RakuMap *map = PyObject_GC_New(RakuMap, &RakuMapType);
+    if (!map) {
+        Py_DECREF(source);
+        return NULL;
+    }
+    Py_INCREF(self);
+    map->func = self;
+    map->source = source;
+    map->results = NULL;
+    map->pos = 0;
+    PyObject_GC_Track(map);
+    return (PyObject *)map;
+}
+
+static PyObject* raku_map_next(RakuMap *self) {
+    if (self->results && self->pos < PyList_GET_SIZE(self->results)) {
+        PyObject *item = PyList_GET_ITEM(self->results, self->pos++);
+        Py_INCREF(item);
+        return item;
+    }
+    Py_CLEAR(self->results);
+    if (!self->source || !self->func) return NULL;
+
+    PyObject *chunk = PyList_New(0);
+    if (!chunk) return NULL;
+    PyObject *item;
+    while (PyList_GET_SIZE(chunk) < self->func->batch && (item = PyIter_Next(self->source))) {
+        int rc = PyList_Append(chunk, item);
+        Py_DECREF(item);
+        if (rc < 0) {
+            Py_DECREF(chunk);
+            return NULL;
+        }
+    }
+    if (PyErr_Occurred() || PyList_GET_SIZE(chunk) == 0) {
+        Py_DECREF(chunk);
+        Py_CLEAR(self->source);
+        return NULL;
+    }
+
+    if (!raku_vector_callbacks.call_raku_batch) {
+        Py_DECREF(chunk);
+        PyErr_SetString(PyExc_RuntimeError, "Raku callbacks are not registered");
+        return NULL;
+    }
+    PyObject *error = NULL;
+    PyObject *results = raku_callback_result(
+        raku_vector_callbacks.call_raku_batch(self->func->raku_index, chunk, &error), error);
+    Py_ssize_t expected = PyList_GET_SIZE(chunk);
+    Py_DECREF(chunk);
+    if (!results) return NULL;
+
+    if (!PyList_Check(results) || PyList_GET_SIZE(results) != expected) {
+        Py_DECREF(results);
+        PyErr_SetString(PyExc_RuntimeError, "Batched Raku callable must return one result per item");
+        return NULL;
+    }
+    self->results = results;
+    self->pos = 0;
+    return raku_map_next(self);
+}
+
+static int raku_map_traverse(RakuMap *self, visitproc visit, void *arg) {
+    Py_VISIT(self->func);
+    Py_VISIT(self->source);
+    Py_VISIT(self->results);
+    return 0;
+}
+
+static int raku_map_clear(RakuMap *self) {
+    Py_CLEAR(self->func);
+    Py_CLEAR(self->source);
+    Py_CLEAR(self->results);
+    return 0;
+}
+
+static void raku_map_dealloc(RakuMap *self) {
+    PyObject_GC_UnTrack(self);
+    raku_map_clear(self);
+    PyObject_GC_Del(self);
+}
+
+static PyTypeObject RakuMapType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "python3.RakuMap",
+    .tp_doc = "Batched map over a Raku callable",
+    .tp_basicsize = sizeof(RakuMap),
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+    .tp_dealloc = (destructor)raku_map_dealloc,
+    .tp_traverse = (traverseproc)raku_map_traverse,
+    .tp_clear = (inquiry)raku_map_clear,
+    .tp_iter = PyObject_SelfIter,
+    .tp_iternext = (iternextfunc)raku_map_next,
+};
+
+static int raku_types_ready(void) {
+    return PyType_Ready(&RakuObjectType) == 0 && PyType_Ready(&RakuMethodType) == 0
+        && PyType_Ready(&RakuMapType) == 0;
+}
+
+// Python-side stand-in for the Raku object at index of the registry;
+// batch > 0 makes map() send that many items per callback
+PyObject* python3_raku_object_new(int index, Py_ssize_t batch) {
+    PY3_GIL;
+    if (!raku_types_ready()) return NULL;
+    RakuObject *self = (RakuObject *)raku_object_new(&RakuObjectType, NULL, NULL);
+    if (!self) return NULL;
+    self->raku_index = index;
+    self->registered = 1;
+    self->batch = batch > 0 ? batch : 0;
+    return (PyObject *)self;
+}
+
+// Copy up to max registry indexes of Raku objects Python no longer uses into out
+Py_ssize_t python3_raku_take_released(int *out, Py_ssize_t max) {
+    PY3_GIL;
+    Py_ssize_t n = released_objects_count < max ? released_objects_count : max;
+    released_objects_count -= n;
+    memcpy(out, released_objects + released_objects_count, n * sizeof(int));
+    return n;
+}
+
+// Module methods
+static PyObject* python3_call_raku(PyObject *self, PyObject *args) {
+    int index;
+    PyObject *params;
+    
+    if (!PyArg_ParseTuple(args, "iO", &index, &params)) {
+        return NULL;
+    }
+    
+    PyObject *error = NULL;
+    PyObject *result = raku_callbacks.call_raku_object(index, params, &error);
+    
+    if (error) {
+        PyErr_SetObject(PyExc_RuntimeError, error);
+        py3_release(error);
+        return NULL;
+    }
+    
+    return py3_own(result);
+}
+
+static PyObject* python3_invoke_raku(PyObject *self, PyObject *args) {
+    int index;
+    const char *method;
+    PyObject *params;
+    
+    if (!PyArg_ParseTuple(args, "isO", &index, &method, &params)) {
+        return NULL;
     }
     
     PyObject *error = NULL;
@@ -463,11 +1859,11 @@ static PyObject* python3_invoke_raku(PyObject *self, PyObject *args) {
     
     if (error) {
         PyErr_SetObject(PyExc_RuntimeError, error);
-        Py_DECREF(error);
+        py3_release(error);
         return NULL;
     }
     
-    return result;
+    return py3_own(result);
 }
 
 static PyMethodDef python3_methods[] = {
@@ -490,7 +1886,8 @@ PyObject* PyInit_python3(void) {
         return NULL;
     }
     
-    if (PyType_Ready(&RakuObjectType) < 0) {
+    if (!raku_types_ready()) {
+        Py_DECREF(m);
         return NULL;
     }
     
@@ -509,18 +1906,23 @@ PyObject* PyInit_python3(void) {
 
 // Zero-copy string conversion when possible
 const char* python3_str_to_utf8_zero_copy(PyObject *obj, Py_ssize_t *size) {
+    PY3_GIL;
     // Check if it's a compact ASCII string (common case)
     if (PyUnicode_IS_COMPACT_ASCII(obj)) {
         *size = PyUnicode_GET_LENGTH(obj);
+        PY3_COUNT(bytes_from_python, *size);
         return (const char*)PyUnicode_1BYTE_DATA(obj);
     }
     
     // Fall back to regular conversion
-    return PyUnicode_AsUTF8AndSize(obj, size);
+    const char *data = PyUnicode_AsUTF8AndSize(obj, size);
+    if (data) PY3_COUNT(bytes_from_python, *size);
+    return data;
 }
 
 // Bulk type checking for efficient type dispatch
 void python3_check_type_bulk(PyObject *obj, uint8_t *type_info) {
+    PY3_GIL;
     // Check all common types at once
     type_info[0] = (obj == Py_None);
     type_info[1] = PyBool_Check(obj);
@@ -536,11 +1938,13 @@ void python3_check_type_bulk(PyObject *obj, uint8_t *type_info) {
 
 // Optimized integer creation
 PyObject* python3_int_from_long_opt(long value) {
+    PY3_GIL;
     return PyLong_FromLong(value);
 }
 
 // Fast list creation from array
 PyObject* python3_list_from_array(PyObject **items, Py_ssize_t size) {
+    PY3_GIL;
     PyObject *list = PyList_New(size);
     if (!list) return NULL;
     
@@ -554,6 +1958,7 @@ PyObject* python3_list_from_array(PyObject **items, Py_ssize_t size) {
 
 // Fast tuple creation from array
 PyObject* python3_tuple_from_array(PyObject **items, Py_ssize_t size) {
+    PY3_GIL;
     PyObject *tuple = PyTuple_New(size);
     if (!tuple) return NULL;
     
@@ -567,26 +1972,871 @@ PyObject* python3_tuple_from_array(PyObject **items, Py_ssize_t size) {
 
 // Placeholder cache functions (implemented in Raku for flexibility)
 PyObject* python3_str_from_utf8_cached(const char *str, Py_ssize_t size) {
+    PY3_GIL;
+    PY3_COUNT(bytes_to_python, size);
     return PyUnicode_FromStringAndSize(str, size);
 }
 
-PyObject* python3_get_method_cached(PyObject *obj, const char *name) {
-    return PyObject_GetAttrString(obj, name);
+// obj.<name> through the method resolution cache; name must be interned
+PyObject* python3_get_method_cached(PyObject *obj, PyObject *name) {
+    PY3_GIL;
+    PyObject *attr;
+
+    switch (resolve_attr(obj, name, &attr)) {
+    case PY3_RESOLVE_UNBOUND: {
+        // Bind only because the caller asked for the attribute itself
+        PyObject *bound = Py_TYPE(attr)->tp_descr_get(attr, obj, (PyObject *)Py_TYPE(obj));
+        Py_DECREF(attr);
+        return bound;
+    }
+    case PY3_RESOLVE_GENERIC:
+        return PyObject_GetAttr(obj, name);
+    }
+    return attr;
 }
 
 PyObject* python3_call_fast(PyObject *func, PyObject *args, PyObject *kwargs) {
+    PY3_GIL;
     if (!kwargs || PyDict_Size(kwargs) == 0) {
         return PyObject_CallObject(func, args);
     }
     return PyObject_Call(func, args, kwargs);
 }
 
+// Compiled code cache statistics
 void python3_get_cache_stats(uint64_t *hits, uint64_t *misses, uint64_t *cached) {
-    *hits = 0;
-    *misses = 0;
+    PY3_GIL;
+    *hits = code_cache_hits;
+    *misses = code_cache_misses;
+    *cached = code_cache_used;
+}
+
+void python3_get_method_cache_stats(uint64_t *hits, uint64_t *misses, uint64_t *cached) {
+    PY3_GIL;
+    *hits = method_cache_hits;
+    *misses = method_cache_misses;
     *cached = 0;
+    for (size_t i = 0; i < PY3_METHOD_CACHE_SIZE; i++) {
+        if (method_cache[i].type) (*cached)++;
+    }
 }
 
 void python3_clear_caches(void) {
-    // Caches are managed in Raku
+    PY3_GIL;
+    code_cache_clear();
+    code_cache_hits = 0;
+    code_cache_misses = 0;
+    method_cache_clear();
+    method_cache_hits = 0;
+    method_cache_misses = 0;
+}
+
+// ===== TAGGED BUFFER CONVERSION =====
+// Walks a Python object graph once and serializes it into a flat buffer
+// that the Raku side decodes without further native calls.
+//
+// The buffer is a sequence of 64-bit words. Every record starts with a tag
+// word whose low byte is one of the PY3_TAG_* values; the remaining bits
+// carry the element count for containers and the value for booleans.
+//
+//   NONE               [tag]
+//   BOOL               [tag | value << 8]
+//   INT                [tag] [int64 value]
+//   FLOAT              [tag] [double bits]
+//   STR, BYTES, BIGINT [tag] [arena offset] [byte length]
+//   LIST, TUPLE        [tag | n << 8] followed by n records
+//   DICT               [tag | n << 8] followed by n key/value record pairs
+//   OBJECT             [tag] [index into objects]
+//
+// String, bytes and big-integer payloads (as hex digits) live in a separate
+// byte arena. Text payloads are followed by a NUL there, so unless binary
+// is set the whole arena is UTF-8 that can be decoded in one go and split
+// on NUL.
+// Anything that is not a plain scalar or container is emitted as OBJECT and
+// handed back to the per-object wrapper path; the buffer holds a reference
+// to each of those until it is freed.
+
+enum {
+    PY3_TAG_NONE   = 0,
+    PY3_TAG_BOOL   = 1,
+    PY3_TAG_INT    = 2,
+    PY3_TAG_FLOAT  = 3,
+    PY3_TAG_STR    = 4,
+    PY3_TAG_BYTES  = 5,
+    PY3_TAG_LIST   = 6,
+    PY3_TAG_TUPLE  = 7,
+    PY3_TAG_DICT   = 8,
+    PY3_TAG_BIGINT = 9,
+    PY3_TAG_OBJECT = 10
+};
+
+// Containers nested deeper than this (or self-referencing ones) are
+// returned as opaque objects instead of recursing further
+#define PY3_FLAT_MAX_DEPTH 128
+
+typedef struct {
+    int64_t *words;
+    Py_ssize_t nwords;
+    char *bytes;
+    Py_ssize_t nbytes;
+    PyObject **objects;
+    Py_ssize_t nobjects;
+    Py_ssize_t binary;  // Arena holds bytes payloads or strings containing NUL
+    Py_ssize_t words_cap;
+    Py_ssize_t bytes_cap;
+    Py_ssize_t objects_cap;
+} PythonFlat;
+
+// Single-probe type dispatch; returns one of the PY3_TAG_* values
+static int type_tag(PyObject *obj) {
+    if (obj == Py_None) return PY3_TAG_NONE;
+    if (PyBool_Check(obj)) return PY3_TAG_BOOL;
+    if (PyLong_Check(obj)) {
+        int overflow = 0;
+        PyLong_AsLongLongAndOverflow(obj, &overflow);
+        return overflow ? PY3_TAG_BIGINT : PY3_TAG_INT;
+    }
+    if (PyFloat_Check(obj)) return PY3_TAG_FLOAT;
+    if (PyUnicode_Check(obj)) return PY3_TAG_STR;
+    if (PyBytes_Check(obj)) return PY3_TAG_BYTES;
+    if (PyList_Check(obj)) return PY3_TAG_LIST;
+    if (PyTuple_Check(obj)) return PY3_TAG_TUPLE;
+    if (PyDict_Check(obj)) return PY3_TAG_DICT;
+    return PY3_TAG_OBJECT;
+}
+
+int python3_type_tag(PyObject *obj) {
+    PY3_GIL;
+    return type_tag(obj);
+}
+
+static int flat_grow(void **buf, Py_ssize_t *cap, Py_ssize_t need, size_t elem) {
+    if (need <= *cap) return 0;
+
+    Py_ssize_t new_cap = *cap ? *cap * 2 : 64;
+    while (new_cap < need) new_cap *= 2;
+
+    void *grown = realloc(*buf, new_cap * elem);
+    if (!grown) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    *buf = grown;
+    *cap = new_cap;
+    return 0;
+}
+
+static int flat_word(PythonFlat *flat, int64_t word) {
+    if (flat_grow((void **)&flat->words, &flat->words_cap, flat->nwords + 1, sizeof(int64_t)) < 0) {
+        return -1;
+    }
+    flat->words[flat->nwords++] = word;
+    return 0;
+}
+
+static int flat_bytes(PythonFlat *flat, int tag, const char *data, Py_ssize_t size) {
+    int text = tag != PY3_TAG_BYTES;
+    if (flat_grow((void **)&flat->bytes, &flat->bytes_cap, flat->nbytes + size + text, 1) < 0) {
+        return -1;
+    }
+    memcpy(flat->bytes + flat->nbytes, data, size);
+
+    if (flat_word(flat, tag) < 0 ||
+        flat_word(flat, flat->nbytes) < 0 ||
+        flat_word(flat, size) < 0) {
+        return -1;
+    }
+    flat->nbytes += size;
+
+    if (!text || memchr(data, '\0', size)) flat->binary = 1;
+    if (text) flat->bytes[flat->nbytes++] = '\0';
+    return 0;
+}
+
+static int flat_object(PythonFlat *flat, PyObject *obj) {
+    if (flat_grow((void **)&flat->objects, &flat->objects_cap, flat->nobjects + 1, sizeof(PyObject *)) < 0) {
+        return -1;
+    }
+    Py_INCREF(obj);
+    flat->objects[flat->nobjects] = obj;
+
+    if (flat_word(flat, PY3_TAG_OBJECT) < 0 ||
+        flat_word(flat, flat->nobjects) < 0) {
+        return -1;
+    }
+    flat->nobjects++;
+    return 0;
+}
+
+static int flat_walk(PythonFlat *flat, PyObject *obj, int depth) {
+    switch (type_tag(obj)) {
+        case PY3_TAG_NONE:
+            return flat_word(flat, PY3_TAG_NONE);
+
+        case PY3_TAG_BOOL:
+            return flat_word(flat, PY3_TAG_BOOL | ((int64_t)(obj == Py_True) << 8));
+
+        case PY3_TAG_INT: {
+            long long value = PyLong_AsLongLong(obj);
+            if (value == -1 && PyErr_Occurred()) return -1;
+
+            if (flat_word(flat, PY3_TAG_INT) < 0) return -1;
+            return flat_word(flat, value);
+        }
+
+        case PY3_TAG_BIGINT: {
+            // Too wide for int64: ship the hex digits instead
+            PyObject *digits = PyNumber_ToBase(obj, 16);
+            if (!digits) return -1;
+            Py_ssize_t size;
+            const char *str = PyUnicode_AsUTF8AndSize(digits, &size);
+            int rc = str ? flat_bytes(flat, PY3_TAG_BIGINT, str, size) : -1;
+            Py_DECREF(digits);
+            return rc;
+        }
+
+        case PY3_TAG_FLOAT: {
+            double value = PyFloat_AS_DOUBLE(obj);
+            int64_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            if (flat_word(flat, PY3_TAG_FLOAT) < 0) return -1;
+            return flat_word(flat, bits);
+        }
+
+        case PY3_TAG_STR: {
+            Py_ssize_t size;
+            const char *str = PyUnicode_AsUTF8AndSize(obj, &size);
+            if (!str) return -1;
+            return flat_bytes(flat, PY3_TAG_STR, str, size);
+        }
+
+        case PY3_TAG_BYTES:
+            return flat_bytes(flat, PY3_TAG_BYTES, PyBytes_AS_STRING(obj), PyBytes_GET_SIZE(obj));
+
+        case PY3_TAG_LIST:
+        case PY3_TAG_TUPLE: {
+            if (depth >= PY3_FLAT_MAX_DEPTH) return flat_object(flat, obj);
+
+            int is_list = PyList_Check(obj);
+            Py_ssize_t size = is_list ? PyList_GET_SIZE(obj) : PyTuple_GET_SIZE(obj);
+            int tag = is_list ? PY3_TAG_LIST : PY3_TAG_TUPLE;
+            if (flat_word(flat, tag | ((int64_t)size << 8)) < 0) return -1;
+
+            for (Py_ssize_t i = 0; i < size; i++) {
+                PyObject *item = is_list ? PyList_GET_ITEM(obj, i) : PyTuple_GET_ITEM(obj, i);
+                if (flat_walk(flat, item, depth + 1) < 0) return -1;
+            }
+            return 0;
+        }
+
+        case PY3_TAG_DICT: {
+            if (depth >= PY3_FLAT_MAX_DEPTH) return flat_object(flat, obj);
+
+            Py_ssize_t size = PyDict_GET_SIZE(obj);
+            if (flat_word(flat, PY3_TAG_DICT | ((int64_t)size << 8)) < 0) return -1;
+
+            Py_ssize_t pos = 0;
+            PyObject *key, *value;
+            while (PyDict_Next(obj, &pos, &key, &value)) {
+                if (flat_walk(flat, key, depth + 1) < 0) return -1;
+                if (flat_walk(flat, value, depth + 1) < 0) return -1;
+            }
+            return 0;
+        }
+
+        default:
+            return flat_object(flat, obj);
+    }
+}
+
+void python3_flat_free(PythonFlat *flat) {
+    PY3_GIL;
+    if (!flat) return;
+
+    for (Py_ssize_t i = 0; i < flat->nobjects; i++) {
+        Py_DECREF(flat->objects[i]);
+    }
+    free(flat->objects);
+    free(flat->words);
+    free(flat->bytes);
+    free(flat);
+}
+
+// Serialize obj into a newly allocated tagged buffer. Returns NULL with a
+// Python exception set on failure; release the result with python3_flat_free.
+PythonFlat* python3_flatten(PyObject *obj) {
+    PY3_GIL;
+    PythonFlat *flat = calloc(1, sizeof(PythonFlat));
+    if (!flat) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    if (flat_walk(flat, obj, 0) < 0) {
+        python3_flat_free(flat);
+        return NULL;
+    }
+
+    PY3_COUNT(bytes_from_python, flat->nwords * sizeof(int64_t) + flat->nbytes);
+    return flat;
+}
+
+// ===== TYPED ARRAYS =====
+// Numeric lists cross the boundary as flat C arrays: a Raku native array
+// is the source or the destination, and the Python ints or floats are
+// boxed or unboxed in one tight loop instead of one call per element.
+
+PyObject* python3_list_from_int64(const int64_t *values, Py_ssize_t count) {
+    PY3_GIL;
+    PY3_COUNT(bytes_to_python, count * sizeof(int64_t));
+    PyObject *list = PyList_New(count);
+    if (!list) return NULL;
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        PyObject *item = PyLong_FromLongLong(values[i]);
+        if (!item) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    return list;
+}
+
+PyObject* python3_list_from_double(const double *values, Py_ssize_t count) {
+    PY3_GIL;
+    PY3_COUNT(bytes_to_python, count * sizeof(double));
+    PyObject *list = PyList_New(count);
+    if (!list) return NULL;
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        PyObject *item = PyFloat_FromDouble(values[i]);
+        if (!item) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    return list;
+}
+
+// PY3_TAG_INT when seq is a list or tuple of at least min_count exact ints
+// that all fit in 64 bits, PY3_TAG_FLOAT when they are all exact floats,
+// 0 otherwise. bool is a subclass of int and never qualifies.
+int python3_numeric_kind(PyObject *seq, Py_ssize_t min_count) {
+    PY3_GIL;
+    if (!PyList_Check(seq) && !PyTuple_Check(seq)) return 0;
+
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    if (count == 0 || count < min_count) return 0;
+
+    PyObject **items = PySequence_Fast_ITEMS(seq);
+    if (PyFloat_CheckExact(items[0])) {
+        for (Py_ssize_t i = 1; i < count; i++) {
+            if (!PyFloat_CheckExact(items[i])) return 0;
+        }
+        return PY3_TAG_FLOAT;
+    }
+    if (!PyLong_CheckExact(items[0])) return 0;
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        int overflow;
+        if (!PyLong_CheckExact(items[i])) return 0;
+        PyLong_AsLongLongAndOverflow(items[i], &overflow);
+        if (overflow) return 0;
+    }
+    return PY3_TAG_INT;
+}
+
+// Unbox a sequence vetted by python3_numeric_kind into out, which has room
+// for count values. Returns -1 if the sequence no longer has count items
+// of that kind, i.e. another thread changed it in between.
+int python3_list_to_int64(PyObject *seq, int64_t *out, Py_ssize_t count) {
+    PY3_GIL;
+    if (PySequence_Fast_GET_SIZE(seq) != count) return -1;
+
+    PyObject **items = PySequence_Fast_ITEMS(seq);
+    for (Py_ssize_t i = 0; i < count; i++) {
+        int overflow;
+        if (!PyLong_CheckExact(items[i])) return -1;
+        out[i] = PyLong_AsLongLongAndOverflow(items[i], &overflow);
+        if (overflow) return -1;
+    }
+    PY3_COUNT(bytes_from_python, count * sizeof(int64_t));
+    return 0;
+}
+
+int python3_list_to_double(PyObject *seq, double *out, Py_ssize_t count) {
+    PY3_GIL;
+    if (PySequence_Fast_GET_SIZE(seq) != count) return -1;
+
+    PyObject **items = PySequence_Fast_ITEMS(seq);
+    for (Py_ssize_t i = 0; i < count; i++) {
+        if (!PyFloat_CheckExact(items[i])) return -1;
+        out[i] = PyFloat_AS_DOUBLE(items[i]);
+    }
+    PY3_COUNT(bytes_from_python, count * sizeof(double));
+    return 0;
+}
+
+// ===== LAZY CONTAINER ACCESS =====
+// Element access for Raku proxies of lists, tuples and dicts, which convert
+// only what is read. Items are returned as new references so they stay
+// valid even if another thread mutates the container.
+
+Py_ssize_t python3_sequence_size(PyObject *seq) {
+    PY3_GIL;
+    if (PyList_Check(seq)) return PyList_GET_SIZE(seq);
+    if (PyTuple_Check(seq)) return PyTuple_GET_SIZE(seq);
+    return PyObject_Size(seq);
+}
+
+// NULL with IndexError when index is out of range
+PyObject* python3_sequence_item(PyObject *seq, Py_ssize_t index) {
+    PY3_GIL;
+    PyObject *item;
+    if (PyList_Check(seq)) {
+        if (index < 0 || index >= PyList_GET_SIZE(seq)) goto out_of_range;
+        item = PyList_GET_ITEM(seq, index);
+    }
+    else if (PyTuple_Check(seq)) {
+        if (index < 0 || index >= PyTuple_GET_SIZE(seq)) goto out_of_range;
+        item = PyTuple_GET_ITEM(seq, index);
+    }
+    else {
+        return PySequence_GetItem(seq, index);
+    }
+    Py_INCREF(item);
+    return item;
+
+out_of_range:
+    PyErr_SetString(PyExc_IndexError, "index out of range");
+    return NULL;
+}
+
+// NULL without an exception when the key is missing; with one when the key
+// can't be hashed
+PyObject* python3_dict_lookup(PyObject *dict, PyObject *key) {
+    PY3_GIL;
+    PyObject *value = PyDict_GetItemWithError(dict, key);
+    Py_XINCREF(value);
+    return value;
+}
+
+// 1 if present, 0 if not, -1 on error
+int python3_dict_contains(PyObject *dict, PyObject *key) {
+    PY3_GIL;
+    return PyDict_Contains(dict, key);
+}
+
+// ===== ITERATION =====
+// Streams any iterable to Raku in chunks: one native call fetches up to n
+// items, so a generator or DB cursor is drained at a fraction of the cost
+// of calling __next__ per item, and without materializing it.
+
+PyObject* python3_get_iter(PyObject *obj) {
+    PY3_GIL;
+    return PyObject_GetIter(obj);
+}
+
+// Store up to n new references from iter in out. Returns how many were
+// stored; fewer than n means the iterator is exhausted. StopIteration is
+// consumed by PyIter_Next, so exhaustion never surfaces as an exception.
+// Returns -1 with the exception set if the iterator raises anything else;
+// items fetched before that are released.
+Py_ssize_t python3_iter_next_batch(PyObject *iter, Py_ssize_t n, PyObject **out) {
+    PY3_GIL;
+    Py_ssize_t count = 0;
+    while (count < n) {
+        PyObject *item = PyIter_Next(iter);
+        if (!item) break;
+        out[count++] = item;
+    }
+
+    if (PyErr_Occurred()) {
+        while (count > 0) Py_DECREF(out[--count]);
+        return -1;
+    }
+    return count;
+}
+
+// ===== BUFFER VIEWS =====
+// Zero-copy access to anything that supports the buffer protocol (bytes,
+// bytearray, memoryview, array.array, NumPy arrays). A view pins its
+// exporter until it is released, so e.g. a bytearray can't be resized
+// underneath Raku.
+
+typedef struct {
+    void *data;
+    Py_ssize_t len;
+    Py_ssize_t readonly;
+    Py_buffer view;
+} PythonBufferView;
+
+// Returns NULL with a Python exception set when obj has no C-contiguous
+// buffer, or no writable one when writable is requested
+PythonBufferView* python3_buffer_get(PyObject *obj, int writable) {
+    PY3_GIL;
+    PythonBufferView *buffer = malloc(sizeof(PythonBufferView));
+    if (!buffer) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    int flags = PyBUF_C_CONTIGUOUS | (writable ? PyBUF_WRITABLE : 0);
+    if (PyObject_GetBuffer(obj, &buffer->view, flags) < 0) {
+        free(buffer);
+        return NULL;
+    }
+
+    buffer->data = buffer->view.buf;
+    buffer->len = buffer->view.len;
+    buffer->readonly = buffer->view.readonly;
+    return buffer;
+}
+
+void python3_buffer_release(PythonBufferView *buffer) {
+    if (!buffer) return;
+    PY3_GIL;
+    PyBuffer_Release(&buffer->view);
+    free(buffer);
+}
+
+// The other direction: Raku memory exported to Python. Python sees a
+// memoryview over a RakuBuffer, which remembers the handle under which the
+// Raku side keeps the memory alive. When the last view is gone the handle
+// is queued, and Raku drops the pin the next time it drains the queue.
+// Native arrays are exported with their element format, so the view (and
+// a NumPy array made from it) is typed rather than a run of bytes.
+typedef struct {
+    PyObject_HEAD
+    void *data;
+    Py_ssize_t len;
+    Py_ssize_t count;
+    Py_ssize_t itemsize;
+    char format[4];
+    int readonly;
+    int64_t handle;
+} RakuBuffer;
+
+static int64_t *released_buffers = NULL;
+static Py_ssize_t released_count = 0;
+static Py_ssize_t released_cap = 0;
+
+static int raku_buffer_getbuffer(RakuBuffer *self, Py_buffer *view, int flags) {
+    if (PyBuffer_FillInfo(view, (PyObject *)self, self->data, self->len, self->readonly, flags) < 0) {
+        return -1;
+    }
+    // A one-dimensional array of count items; for bytes this is exactly
+    // what PyBuffer_FillInfo reports
+    view->itemsize = self->itemsize;
+    view->format = (flags & PyBUF_FORMAT) ? self->format : NULL;
+    view->shape = (flags & PyBUF_ND) ? &self->count : NULL;
+    view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? &self->itemsize : NULL;
+    return 0;
+}
+
+static void raku_buffer_dealloc(RakuBuffer *self) {
+    if (released_count == released_cap) {
+        Py_ssize_t cap = released_cap ? released_cap * 2 : 64;
+        int64_t *grown = realloc(released_buffers, cap * sizeof(int64_t));
+        if (grown) {
+            released_buffers = grown;
+            released_cap = cap;
+        }
+    }
+    // Without room the pin is simply kept for the rest of the process
+    if (released_count < released_cap) {
+        released_buffers[released_count++] = self->handle;
+    }
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyBufferProcs raku_buffer_procs = {
+    .bf_getbuffer = (getbufferproc)raku_buffer_getbuffer,
+};
+
+static PyTypeObject RakuBufferType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "python3.RakuBuffer",
+    .tp_doc = "Raku buffer exported to Python",
+    .tp_basicsize = sizeof(RakuBuffer),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = (destructor)raku_buffer_dealloc,
+    .tp_as_buffer = &raku_buffer_procs,
+};
+
+// A memoryview of count items of itemsize bytes each. format is a struct
+// module code such as "d" (double) or "q" (int64).
+PyObject* python3_array_view_from_memory(void *data, Py_ssize_t count, Py_ssize_t itemsize,
+                                         const char *format, int writable, int64_t handle) {
+    PY3_GIL;
+    if (!(RakuBufferType.tp_flags & Py_TPFLAGS_READY) && PyType_Ready(&RakuBufferType) < 0) {
+        return NULL;
+    }
+    if (itemsize < 1 || !format || strlen(format) >= sizeof(((RakuBuffer *)0)->format)) {
+        PyErr_SetString(PyExc_ValueError, "invalid buffer item format");
+        return NULL;
+    }
+
+    RakuBuffer *exporter = PyObject_New(RakuBuffer, &RakuBufferType);
+    if (!exporter) return NULL;
+    exporter->data = data;
+    exporter->count = count;
+    exporter->itemsize = itemsize;
+    exporter->len = count * itemsize;
+    strcpy(exporter->format, format);
+    exporter->readonly = !writable;
+    exporter->handle = handle;
+
+    // The memoryview holds the only reference to the exporter
+    PyObject *view = PyMemoryView_FromObject((PyObject *)exporter);
+    Py_DECREF(exporter);
+    return view;
+}
+
+PyObject* python3_memoryview_from_memory(void *data, Py_ssize_t len, int writable, int64_t handle) {
+    return python3_array_view_from_memory(data, len, 1, "B", writable, handle);
+}
+
+// A NumPy array sharing the memory of a view; the array's base keeps the
+// view, and through it the Raku memory, alive. Without NumPy the view
+// itself is returned.
+PyObject* python3_ndarray_from_view(PyObject *view) {
+    PY3_GIL;
+    PyObject *numpy = PyImport_ImportModule("numpy");
+    if (!numpy) {
+        if (!PyErr_ExceptionMatches(PyExc_ImportError)) return NULL;
+        PyErr_Clear();
+        Py_INCREF(view);
+        return view;
+    }
+    PyObject *array = PyObject_CallMethod(numpy, "asarray", "O", view);
+    Py_DECREF(numpy);
+    return array;
+}
+
+// Copy up to max handles of Raku buffers Python no longer uses into out
+Py_ssize_t python3_buffer_take_released(int64_t *out, Py_ssize_t max) {
+    PY3_GIL;
+    Py_ssize_t n = released_count < max ? released_count : max;
+    released_count -= n;
+    memcpy(out, released_buffers + released_count, n * sizeof(int64_t));
+    return n;
+}
+
+// ===== BATCHED STRING DECODING =====
+// Many str objects are encoded into one UTF-8 arena, with each string
+// followed by a NUL. Raku decodes the arena once and splits it on NUL;
+// NUL is a control character, so it is always a grapheme boundary and
+// neighbouring strings can't merge. When a string contains NUL itself,
+// has_nul is set and the offsets are used instead.
+
+typedef struct {
+    char *bytes;
+    Py_ssize_t nbytes;
+    int64_t *offsets;   // count + 1 entries; string i ends 1 byte before offsets[i + 1]
+    Py_ssize_t count;
+    Py_ssize_t has_nul;
+} PythonStrBatch;
+
+void python3_str_batch_free(PythonStrBatch *batch) {
+    if (!batch) return;
+    free(batch->bytes);
+    free(batch->offsets);
+    free(batch);
+}
+
+// Encode count str objects. Returns NULL with a Python exception set when
+// an item is not a str or can't be encoded.
+PythonStrBatch* python3_str_batch(PyObject **items, Py_ssize_t count) {
+    PY3_GIL;
+    PythonStrBatch *batch = calloc(1, sizeof(PythonStrBatch));
+    if (!batch) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    batch->count = count;
+    batch->offsets = malloc((count + 1) * sizeof(int64_t));
+    if (!batch->offsets) {
+        python3_str_batch_free(batch);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    // First pass: UTF-8 sizes. The UTF-8 form is the string's own data for
+    // ASCII and cached on the object otherwise, so nothing is copied yet.
+    Py_ssize_t total = 0;
+    for (Py_ssize_t i = 0; i < count; i++) {
+        if (!PyUnicode_Check(items[i])) {
+            PyErr_Format(PyExc_TypeError, "expected str, got %.200s", Py_TYPE(items[i])->tp_name);
+            python3_str_batch_free(batch);
+            return NULL;
+        }
+        Py_ssize_t size;
+        if (!PyUnicode_AsUTF8AndSize(items[i], &size)) {
+            python3_str_batch_free(batch);
+            return NULL;
+        }
+        batch->offsets[i] = total;
+        total += size + 1;
+    }
+    batch->offsets[count] = total;
+
+    batch->bytes = malloc(total ? total : 1);
+    if (!batch->bytes) {
+        python3_str_batch_free(batch);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    // Second pass: one copy into the arena
+    for (Py_ssize_t i = 0; i < count; i++) {
+        Py_ssize_t size;
+        const char *data = PyUnicode_AsUTF8AndSize(items[i], &size);
+        char *dest = batch->bytes + batch->offsets[i];
+        memcpy(dest, data, size);
+        dest[size] = '\0';
+        if (!batch->has_nul && memchr(data, '\0', size)) batch->has_nul = 1;
+    }
+    batch->nbytes = total;
+    PY3_COUNT(bytes_from_python, total);
+
+    return batch;
+}
+
+// ===== SUB-INTERPRETERS =====
+// Backing for Inline::Python3::Pool. Each sub-interpreter is owned by one
+// OS thread: it is created, entered, left and destroyed on that thread.
+// On Python 3.12+ it can get its own GIL so pool members run Python code
+// in parallel; otherwise it shares the main GIL. Requires threaded mode,
+// since creation and teardown briefly take the main interpreter's GIL.
+
+typedef struct {
+    PyThreadState *tstate;
+    PyObject *globals;
+    int own_gil;
+} Py3SubInterpreter;
+
+static PyThreadState* new_subinterpreter(int own_gil, int *got_own_gil) {
+    *got_own_gil = 0;
+
+#if PY_VERSION_HEX >= 0x030C0000
+    if (own_gil) {
+        PyThreadState *tstate = NULL;
+        PyInterpreterConfig config = {
+            .use_main_obmalloc = 0,
+            .allow_fork = 0,
+            .allow_exec = 0,
+            .allow_threads = 1,
+            .allow_daemon_threads = 0,
+            .check_multi_interp_extensions = 1,
+            .gil = PyInterpreterConfig_OWN_GIL,
+        };
+        PyStatus status = Py_NewInterpreterFromConfig(&tstate, &config);
+        if (!PyStatus_Exception(status) && tstate) {
+            *got_own_gil = 1;
+            return tstate;
+        }
+    }
+#else
+    (void)own_gil;
+#endif
+
+    // Shared-GIL fallback
+    return Py_NewInterpreter();
+}
+
+int python3_subinterp_own_gil_supported(void) {
+    return PY_VERSION_HEX >= 0x030C0000;
+}
+
+// Creation and teardown run on a throwaway main-interpreter thread state
+// rather than PyGILState: since 3.12 activating a sub-interpreter's thread
+// state rebinds the thread's GILState slot to it, so PyGILState_Ensure on
+// a pool thread would hand back the sub-interpreter instead of main.
+static PyThreadState* enter_main_interpreter(void) {
+    PyThreadState *tstate = PyThreadState_New(main_thread_state->interp);
+    PyEval_RestoreThread(tstate);
+    return tstate;
+}
+
+static void leave_main_interpreter(PyThreadState *tstate) {
+    PyThreadState_Clear(tstate);
+    PyEval_SaveThread();
+    PyThreadState_Delete(tstate);
+}
+
+// Create a sub-interpreter owned by the calling thread. Nothing is left
+// current on return; use python3_subinterp_enter before running code.
+Py3SubInterpreter* python3_subinterp_new(int own_gil) {
+    if (!threads_enabled) return NULL;
+
+    Py3SubInterpreter *sub = calloc(1, sizeof(Py3SubInterpreter));
+    if (!sub) return NULL;
+
+    PyThreadState *main_tstate = enter_main_interpreter();
+
+    sub->tstate = new_subinterpreter(own_gil, &sub->own_gil);
+    if (!sub->tstate) {
+        PyThreadState_Swap(main_tstate);
+        leave_main_interpreter(main_tstate);
+        free(sub);
+        return NULL;
+    }
+
+    // Fresh globals with __builtins__ and __name__, like Inline::Python3.BUILD
+    sub->globals = PyDict_New();
+    if (sub->globals) {
+        PyDict_SetItemString(sub->globals, "__builtins__", PyEval_GetBuiltins());
+        PyObject *name = PyUnicode_FromString("__main__");
+        if (name) {
+            PyDict_SetItemString(sub->globals, "__name__", name);
+            Py_DECREF(name);
+        }
+    }
+    PyErr_Clear();
+
+    // Drop the sub-interpreter's GIL and return to the main interpreter
+    PyEval_SaveThread();
+    PyEval_RestoreThread(main_tstate);
+    leave_main_interpreter(main_tstate);
+
+    return sub;
+}
+
+void python3_subinterp_enter(Py3SubInterpreter *sub) {
+    PyEval_RestoreThread(sub->tstate);
+    subinterp_active = 1;
+}
+
+void python3_subinterp_leave(Py3SubInterpreter *sub) {
+    subinterp_active = 0;
+    PyEval_SaveThread();
+}
+
+PyObject* python3_subinterp_globals(Py3SubInterpreter *sub) {
+    return sub->globals;
+}
+
+int python3_subinterp_has_own_gil(Py3SubInterpreter *sub) {
+    return sub->own_gil;
+}
+
+// Tear down a sub-interpreter from the thread that created it
+void python3_subinterp_destroy(Py3SubInterpreter *sub) {
+    if (!sub) return;
+
+    PyThreadState *main_tstate = enter_main_interpreter();
+
+    // Since 3.12 PyThreadState_Swap also hands over the GILs involved;
+    // before that the shared GIL simply stays held throughout
+    PyThreadState_Swap(sub->tstate);
+    Py_CLEAR(sub->globals);
+    Py_EndInterpreter(sub->tstate);
+    PyThreadState_Swap(main_tstate);
+    leave_main_interpreter(main_tstate);
+
+    free(sub);
 }
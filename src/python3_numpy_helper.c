@@ -1,199 +1,609 @@
 // NumPy integration helpers for zero-copy operations
+//
+// Arrays are read through the buffer protocol rather than the NumPy C API,
+// so this file builds without the NumPy headers and works for any strided
+// exporter: ndarrays, memoryviews, array.array. The numeric kernels pick
+// SSE2, AVX2 or AVX-512 code at runtime from what the CPU supports.
 #include <Python.h>
-#include <numpy/arrayobject.h>
-#include <numpy/ndarraytypes.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
-// Initialize NumPy C API
-static int numpy_initialized = 0;
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define PY3_X86_KERNELS 1
+#endif
 
-static void ensure_numpy_initialized() {
-    if (!numpy_initialized) {
-        import_array();
-        numpy_initialized = 1;
-    }
+// Linked into the same library as python3_helper.c, whose exported GIL
+// helpers know about threaded mode and pool sub-interpreters
+int python3_gil_ensure(void);
+void python3_gil_release(int state);
+
+static void numpy_gil_release(int *state) {
+    python3_gil_release(*state);
 }
 
-// Check if object is a NumPy array
+#define NUMPY_GIL int numpy_gil_state __attribute__((cleanup(numpy_gil_release))) = python3_gil_ensure()
+
+// ===== ARRAY METADATA =====
+// Everything Raku needs about an array in one call. The buffer is held
+// until python3_array_release, which keeps the data pointer valid.
+
+typedef struct {
+    void *data;
+    int64_t ndim;
+    int64_t itemsize;
+    int64_t readonly;
+    int64_t size;          // number of elements
+    int64_t *shape;
+    int64_t *strides;      // in bytes; may be negative
+    const char *format;    // struct module code without a native byte order prefix
+    Py_buffer view;
+} PythonArrayInfo;
+
+// Check if object is a NumPy array (or an instance of a subclass)
 int python3_numpy_is_array(PyObject *obj) {
-    ensure_numpy_initialized();
-    return PyArray_Check(obj) ? 1 : 0;
+    NUMPY_GIL;
+    PyObject *mro = Py_TYPE(obj)->tp_mro;
+    if (!mro) return 0;
+    for (Py_ssize_t i = 0; i < PyTuple_GET_SIZE(mro); i++) {
+        PyTypeObject *type = (PyTypeObject *)PyTuple_GET_ITEM(mro, i);
+        if (strcmp(type->tp_name, "numpy.ndarray") == 0) return 1;
+    }
+    return 0;
 }
 
-// Get array data pointer
-void* python3_numpy_array_data(PyObject *obj) {
-    if (!PyArray_Check(obj)) return NULL;
-    return PyArray_DATA((PyArrayObject*)obj);
+// NULL when obj has no strided buffer. Writable buffers are requested
+// first, so readonly is only set for memory that really is read-only.
+PythonArrayInfo* python3_array_info(PyObject *obj) {
+    NUMPY_GIL;
+    PythonArrayInfo *info = calloc(1, sizeof(PythonArrayInfo));
+    if (!info) return NULL;
+
+    if (PyObject_GetBuffer(obj, &info->view, PyBUF_RECORDS) < 0) {
+        PyErr_Clear();
+        if (PyObject_GetBuffer(obj, &info->view, PyBUF_RECORDS_RO) < 0) {
+            PyErr_Clear();
+            free(info);
+            return NULL;
+        }
+    }
+
+    Py_buffer *view = &info->view;
+    int ndim = view->ndim;
+    info->shape = malloc((ndim ? ndim : 1) * 2 * sizeof(int64_t));
+    if (!info->shape) {
+        PyBuffer_Release(view);
+        free(info);
+        return NULL;
+    }
+    info->strides = info->shape + (ndim ? ndim : 1);
+
+    info->data = view->buf;
+    info->ndim = ndim;
+    info->itemsize = view->itemsize;
+    info->readonly = view->readonly;
+    info->size = 1;
+    for (int i = 0; i < ndim; i++) {
+        info->shape[i] = view->shape[i];
+        // Strides are only omitted for C-contiguous memory
+        info->strides[i] = view->strides ? view->strides[i] : 0;
+        info->size *= view->shape[i];
+    }
+    if (!view->strides) {
+        int64_t stride = view->itemsize;
+        for (int i = ndim - 1; i >= 0; i--) {
+            info->strides[i] = stride;
+            stride *= info->shape[i];
+        }
+    }
+
+    const char *format = view->format ? view->format : "B";
+    if (*format == '@' || *format == '=') format++;
+#if PY_LITTLE_ENDIAN
+    if (*format == '<') format++;
+#else
+    if (*format == '>' || *format == '!') format++;
+#endif
+    info->format = format;
+    return info;
 }
 
-// Get array type number
-int python3_numpy_array_type(PyObject *obj) {
-    if (!PyArray_Check(obj)) return -1;
-    return PyArray_TYPE((PyArrayObject*)obj);
+void python3_array_release(PythonArrayInfo *info) {
+    if (!info) return;
+    NUMPY_GIL;
+    PyBuffer_Release(&info->view);
+    free(info->shape);
+    free(info);
 }
 
-// Get item size
-int64_t python3_numpy_array_itemsize(PyObject *obj) {
-    if (!PyArray_Check(obj)) return -1;
-    return PyArray_ITEMSIZE((PyArrayObject*)obj);
+// ===== SIMD KERNELS =====
+// Contiguous float64 kernels, one set per instruction set. Min and max
+// propagate NaN like NumPy does. Sums and dot products use several
+// accumulators, so their rounding can differ from a sequential loop.
+
+typedef struct {
+    const char *name;
+    double (*sum)(const double *x, int64_t n);
+    double (*min)(const double *x, int64_t n);
+    double (*max)(const double *x, int64_t n);
+    double (*dot)(const double *x, const double *y, int64_t n);
+    void (*axpy)(double alpha, const double *x, double *y, int64_t n);
+    void (*scale)(double alpha, double *x, int64_t n);
+} ArrayKernels;
+
+static double scalar_sum(const double *x, int64_t n) {
+    double total = 0.0;
+    for (int64_t i = 0; i < n; i++) total += x[i];
+    return total;
 }
 
-// Get array flags
-int python3_numpy_array_flags(PyObject *obj) {
-    if (!PyArray_Check(obj)) return 0;
-    return PyArray_FLAGS((PyArrayObject*)obj);
+static double scalar_min(const double *x, int64_t n) {
+    double result = INFINITY;
+    for (int64_t i = 0; i < n; i++) {
+        if (isnan(x[i])) return NAN;
+        if (x[i] < result) result = x[i];
+    }
+    return result;
 }
 
-// Get dimensions
-void python3_numpy_array_dims(PyObject *obj, int64_t *dims) {
-    if (!PyArray_Check(obj)) return;
-    
-    PyArrayObject *arr = (PyArrayObject*)obj;
-    int ndim = PyArray_NDIM(arr);
-    npy_intp *shape = PyArray_DIMS(arr);
-    
-    for (int i = 0; i < ndim; i++) {
-        dims[i] = shape[i];
+static double scalar_max(const double *x, int64_t n) {
+    double result = -INFINITY;
+    for (int64_t i = 0; i < n; i++) {
+        if (isnan(x[i])) return NAN;
+        if (x[i] > result) result = x[i];
     }
+    return result;
 }
 
-// Get strides
-void python3_numpy_array_strides(PyObject *obj, int64_t *strides) {
-    if (!PyArray_Check(obj)) return;
-    
-    PyArrayObject *arr = (PyArrayObject*)obj;
-    int ndim = PyArray_NDIM(arr);
-    npy_intp *arr_strides = PyArray_STRIDES(arr);
-    
-    for (int i = 0; i < ndim; i++) {
-        strides[i] = arr_strides[i];
-    }
-}
-
-// Get array struct (for direct access)
-PyArrayObject* python3_numpy_get_array_struct(PyObject *obj) {
-    if (!PyArray_Check(obj)) return NULL;
-    return (PyArrayObject*)obj;
-}
-
-// Create array from data pointer (zero-copy)
-PyObject* python3_numpy_from_data(void *data, int type, int nd, int64_t *dims, int64_t *strides, int flags) {
-    ensure_numpy_initialized();
-    
-    npy_intp *np_dims = malloc(nd * sizeof(npy_intp));
-    npy_intp *np_strides = strides ? malloc(nd * sizeof(npy_intp)) : NULL;
-    
-    for (int i = 0; i < nd; i++) {
-        np_dims[i] = dims[i];
-        if (np_strides) np_strides[i] = strides[i];
-    }
-    
-    PyObject *arr = PyArray_New(&PyArray_Type, nd, np_dims, type, np_strides, 
-                                data, 0, flags, NULL);
-    
-    free(np_dims);
-    if (np_strides) free(np_strides);
-    
-    return arr;
-}
-
-// Fast element access for contiguous arrays
-double python3_numpy_get_double(PyObject *obj, int64_t index) {
-    if (!PyArray_Check(obj)) return 0.0;
-    
-    PyArrayObject *arr = (PyArrayObject*)obj;
-    if (PyArray_TYPE(arr) != NPY_DOUBLE) return 0.0;
-    if (!PyArray_IS_C_CONTIGUOUS(arr)) return 0.0;
-    
-    double *data = (double*)PyArray_DATA(arr);
-    return data[index];
-}
-
-void python3_numpy_set_double(PyObject *obj, int64_t index, double value) {
-    if (!PyArray_Check(obj)) return;
-    
-    PyArrayObject *arr = (PyArrayObject*)obj;
-    if (PyArray_TYPE(arr) != NPY_DOUBLE) return;
-    if (!PyArray_IS_C_CONTIGUOUS(arr)) return;
-    if (!(PyArray_FLAGS(arr) & NPY_ARRAY_WRITEABLE)) return;
-    
-    double *data = (double*)PyArray_DATA(arr);
-    data[index] = value;
-}
-
-// Fast bulk operations
-void python3_numpy_add_scalar_double(PyObject *obj, double scalar) {
-    if (!PyArray_Check(obj)) return;
-    
-    PyArrayObject *arr = (PyArrayObject*)obj;
-    if (PyArray_TYPE(arr) != NPY_DOUBLE) return;
-    if (!PyArray_IS_C_CONTIGUOUS(arr)) return;
-    if (!(PyArray_FLAGS(arr) & NPY_ARRAY_WRITEABLE)) return;
-    
-    double *data = (double*)PyArray_DATA(arr);
-    npy_intp size = PyArray_SIZE(arr);
-    
-    for (npy_intp i = 0; i < size; i++) {
-        data[i] += scalar;
-    }
-}
-
-// SIMD-optimized operations (if available)
-#ifdef __AVX__
-#include <immintrin.h>
+static double scalar_dot(const double *x, const double *y, int64_t n) {
+    double total = 0.0;
+    for (int64_t i = 0; i < n; i++) total += x[i] * y[i];
+    return total;
+}
+
+static void scalar_axpy(double alpha, const double *x, double *y, int64_t n) {
+    for (int64_t i = 0; i < n; i++) y[i] += alpha * x[i];
+}
+
+static void scalar_scale(double alpha, double *x, int64_t n) {
+    for (int64_t i = 0; i < n; i++) x[i] *= alpha;
+}
+
+static const ArrayKernels scalar_kernels = {
+    "scalar", scalar_sum, scalar_min, scalar_max, scalar_dot, scalar_axpy, scalar_scale,
+};
+
+#ifdef PY3_X86_KERNELS
+
+// SSE2 is part of x86-64, so these need no target attribute
+static double sse2_sum(const double *x, int64_t n) {
+    __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        a0 = _mm_add_pd(a0, _mm_loadu_pd(x + i));
+        a1 = _mm_add_pd(a1, _mm_loadu_pd(x + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(a0, a1));
+    return lanes[0] + lanes[1] + scalar_sum(x + i, n - i);
+}
+
+static double sse2_min(const double *x, int64_t n) {
+    __m128d acc = _mm_set1_pd(INFINITY), nan = _mm_setzero_pd();
+    int64_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d v = _mm_loadu_pd(x + i);
+        nan = _mm_or_pd(nan, _mm_cmpunord_pd(v, v));
+        acc = _mm_min_pd(acc, v);
+    }
+    if (_mm_movemask_pd(nan)) return NAN;
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    double rest = scalar_min(x + i, n - i);
+    if (isnan(rest)) return NAN;
+    double result = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+    return rest < result ? rest : result;
+}
+
+static double sse2_max(const double *x, int64_t n) {
+    __m128d acc = _mm_set1_pd(-INFINITY), nan = _mm_setzero_pd();
+    int64_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d v = _mm_loadu_pd(x + i);
+        nan = _mm_or_pd(nan, _mm_cmpunord_pd(v, v));
+        acc = _mm_max_pd(acc, v);
+    }
+    if (_mm_movemask_pd(nan)) return NAN;
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    double rest = scalar_max(x + i, n - i);
+    if (isnan(rest)) return NAN;
+    double result = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+    return rest > result ? rest : result;
+}
+
+static double sse2_dot(const double *x, const double *y, int64_t n) {
+    __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        a0 = _mm_add_pd(a0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+        a1 = _mm_add_pd(a1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(a0, a1));
+    return lanes[0] + lanes[1] + scalar_dot(x + i, y + i, n - i);
+}
+
+static void sse2_axpy(double alpha, const double *x, double *y, int64_t n) {
+    __m128d a = _mm_set1_pd(alpha);
+    int64_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(a, _mm_loadu_pd(x + i))));
+    }
+    scalar_axpy(alpha, x + i, y + i, n - i);
+}
+
+static void sse2_scale(double alpha, double *x, int64_t n) {
+    __m128d a = _mm_set1_pd(alpha);
+    int64_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(x + i, _mm_mul_pd(a, _mm_loadu_pd(x + i)));
+    }
+    scalar_scale(alpha, x + i, n - i);
+}
+
+static const ArrayKernels sse2_kernels = {
+    "sse2", sse2_sum, sse2_min, sse2_max, sse2_dot, sse2_axpy, sse2_scale,
+};
+
+#define AVX2 __attribute__((target("avx2,fma")))
+
+AVX2 static double avx2_hsum(__m256d v) {
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+}
+
+AVX2 static double avx2_sum(const double *x, int64_t n) {
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        a0 = _mm256_add_pd(a0, _mm256_loadu_pd(x + i));
+        a1 = _mm256_add_pd(a1, _mm256_loadu_pd(x + i + 4));
+    }
+    return avx2_hsum(_mm256_add_pd(a0, a1)) + scalar_sum(x + i, n - i);
+}
+
+AVX2 static double avx2_min(const double *x, int64_t n) {
+    __m256d acc = _mm256_set1_pd(INFINITY), nan = _mm256_setzero_pd();
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_loadu_pd(x + i);
+        nan = _mm256_or_pd(nan, _mm256_cmp_pd(v, v, _CMP_UNORD_Q));
+        acc = _mm256_min_pd(acc, v);
+    }
+    if (_mm256_movemask_pd(nan)) return NAN;
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    double result = scalar_min(x + i, n - i);
+    if (isnan(result)) return NAN;
+    for (int k = 0; k < 4; k++) if (lanes[k] < result) result = lanes[k];
+    return result;
+}
+
+AVX2 static double avx2_max(const double *x, int64_t n) {
+    __m256d acc = _mm256_set1_pd(-INFINITY), nan = _mm256_setzero_pd();
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_loadu_pd(x + i);
+        nan = _mm256_or_pd(nan, _mm256_cmp_pd(v, v, _CMP_UNORD_Q));
+        acc = _mm256_max_pd(acc, v);
+    }
+    if (_mm256_movemask_pd(nan)) return NAN;
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    double result = scalar_max(x + i, n - i);
+    if (isnan(result)) return NAN;
+    for (int k = 0; k < 4; k++) if (lanes[k] > result) result = lanes[k];
+    return result;
+}
+
+AVX2 static double avx2_dot(const double *x, const double *y, int64_t n) {
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        a0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), a0);
+        a1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), a1);
+    }
+    return avx2_hsum(_mm256_add_pd(a0, a1)) + scalar_dot(x + i, y + i, n - i);
+}
+
+AVX2 static void avx2_axpy(double alpha, const double *x, double *y, int64_t n) {
+    __m256d a = _mm256_set1_pd(alpha);
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    }
+    scalar_axpy(alpha, x + i, y + i, n - i);
+}
 
-void python3_numpy_add_arrays_double_avx(PyObject *a, PyObject *b, PyObject *result) {
-    if (!PyArray_Check(a) || !PyArray_Check(b) || !PyArray_Check(result)) return;
-    
-    PyArrayObject *arr_a = (PyArrayObject*)a;
-    PyArrayObject *arr_b = (PyArrayObject*)b;
-    PyArrayObject *arr_result = (PyArrayObject*)result;
-    
-    // Check all arrays are double, contiguous, and same size
-    if (PyArray_TYPE(arr_a) != NPY_DOUBLE || 
-        PyArray_TYPE(arr_b) != NPY_DOUBLE || 
-        PyArray_TYPE(arr_result) != NPY_DOUBLE) return;
-        
-    if (!PyArray_IS_C_CONTIGUOUS(arr_a) || 
-        !PyArray_IS_C_CONTIGUOUS(arr_b) || 
-        !PyArray_IS_C_CONTIGUOUS(arr_result)) return;
-    
-    npy_intp size = PyArray_SIZE(arr_a);
-    if (size != PyArray_SIZE(arr_b) || size != PyArray_SIZE(arr_result)) return;
-    
-    double *data_a = (double*)PyArray_DATA(arr_a);
-    double *data_b = (double*)PyArray_DATA(arr_b);
-    double *data_result = (double*)PyArray_DATA(arr_result);
-    
-    // Process 4 doubles at a time with AVX
-    npy_intp simd_size = size - (size % 4);
-    for (npy_intp i = 0; i < simd_size; i += 4) {
-        __m256d va = _mm256_loadu_pd(&data_a[i]);
-        __m256d vb = _mm256_loadu_pd(&data_b[i]);
-        __m256d vresult = _mm256_add_pd(va, vb);
-        _mm256_storeu_pd(&data_result[i], vresult);
-    }
-    
-    // Handle remaining elements
-    for (npy_intp i = simd_size; i < size; i++) {
-        data_result[i] = data_a[i] + data_b[i];
+AVX2 static void avx2_scale(double alpha, double *x, int64_t n) {
+    __m256d a = _mm256_set1_pd(alpha);
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(x + i, _mm256_mul_pd(a, _mm256_loadu_pd(x + i)));
     }
+    scalar_scale(alpha, x + i, n - i);
 }
+
+static const ArrayKernels avx2_kernels = {
+    "avx2", avx2_sum, avx2_min, avx2_max, avx2_dot, avx2_axpy, avx2_scale,
+};
+
+#define AVX512 __attribute__((target("avx512f")))
+
+AVX512 static double avx512_sum(const double *x, int64_t n) {
+    __m512d a0 = _mm512_setzero_pd(), a1 = _mm512_setzero_pd();
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        a0 = _mm512_add_pd(a0, _mm512_loadu_pd(x + i));
+        a1 = _mm512_add_pd(a1, _mm512_loadu_pd(x + i + 8));
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(a0, a1)) + scalar_sum(x + i, n - i);
+}
+
+AVX512 static double avx512_min(const double *x, int64_t n) {
+    __m512d acc = _mm512_set1_pd(INFINITY);
+    __mmask8 nan = 0;
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d v = _mm512_loadu_pd(x + i);
+        nan |= _mm512_cmp_pd_mask(v, v, _CMP_UNORD_Q);
+        acc = _mm512_min_pd(acc, v);
+    }
+    if (nan) return NAN;
+    double result = scalar_min(x + i, n - i);
+    if (isnan(result)) return NAN;
+    double lanes = _mm512_reduce_min_pd(acc);
+    return lanes < result ? lanes : result;
+}
+
+AVX512 static double avx512_max(const double *x, int64_t n) {
+    __m512d acc = _mm512_set1_pd(-INFINITY);
+    __mmask8 nan = 0;
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d v = _mm512_loadu_pd(x + i);
+        nan |= _mm512_cmp_pd_mask(v, v, _CMP_UNORD_Q);
+        acc = _mm512_max_pd(acc, v);
+    }
+    if (nan) return NAN;
+    double result = scalar_max(x + i, n - i);
+    if (isnan(result)) return NAN;
+    double lanes = _mm512_reduce_max_pd(acc);
+    return lanes > result ? lanes : result;
+}
+
+AVX512 static double avx512_dot(const double *x, const double *y, int64_t n) {
+    __m512d a0 = _mm512_setzero_pd(), a1 = _mm512_setzero_pd();
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        a0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), a0);
+        a1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8), a1);
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(a0, a1)) + scalar_dot(x + i, y + i, n - i);
+}
+
+AVX512 static void avx512_axpy(double alpha, const double *x, double *y, int64_t n) {
+    __m512d a = _mm512_set1_pd(alpha);
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(y + i, _mm512_fmadd_pd(a, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    }
+    scalar_axpy(alpha, x + i, y + i, n - i);
+}
+
+AVX512 static void avx512_scale(double alpha, double *x, int64_t n) {
+    __m512d a = _mm512_set1_pd(alpha);
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(x + i, _mm512_mul_pd(a, _mm512_loadu_pd(x + i)));
+    }
+    scalar_scale(alpha, x + i, n - i);
+}
+
+static const ArrayKernels avx512_kernels = {
+    "avx512", avx512_sum, avx512_min, avx512_max, avx512_dot, avx512_axpy, avx512_scale,
+};
+
+#endif // PY3_X86_KERNELS
+
+// The best kernel set the CPU supports. INLINE_PYTHON3_SIMD (scalar, sse2,
+// avx2 or avx512) caps the choice, e.g. to compare them in benchmarks.
+static const ArrayKernels *active_kernels = NULL;
+
+static const ArrayKernels* array_kernels(void) {
+    if (active_kernels) return active_kernels;
+
+    const ArrayKernels *chosen = &scalar_kernels;
+#ifdef PY3_X86_KERNELS
+    const char *cap = getenv("INLINE_PYTHON3_SIMD");
+    int limit = 3;
+    if (cap) {
+        limit = strcmp(cap, "scalar") == 0 ? 0
+              : strcmp(cap, "sse2") == 0 ? 1
+              : strcmp(cap, "avx2") == 0 ? 2 : 3;
+    }
+    __builtin_cpu_init();
+    if (limit >= 3 && __builtin_cpu_supports("avx512f")) {
+        chosen = &avx512_kernels;
+    } else if (limit >= 2 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        chosen = &avx2_kernels;
+    } else if (limit >= 1) {
+        chosen = &sse2_kernels;
+    }
 #endif
+    // Every thread picks the same set, so a racing first call is harmless
+    active_kernels = chosen;
+    return chosen;
+}
+
+const char* python3_simd_level(void) {
+    return array_kernels()->name;
+}
 
-// Type string from type number
-const char* python3_numpy_type_string(int type_num) {
-    switch(type_num) {
-        case NPY_BOOL: return "bool";
-        case NPY_BYTE: return "int8";
-        case NPY_UBYTE: return "uint8";
-        case NPY_SHORT: return "int16";
-        case NPY_USHORT: return "uint16";
-        case NPY_INT: return "int32";
-        case NPY_UINT: return "uint32";
-        case NPY_LONG: return "int64";
-        case NPY_ULONG: return "uint64";
-        case NPY_FLOAT: return "float32";
-        case NPY_DOUBLE: return "float64";
-        default: return "unknown";
-    }
-}
\ No newline at end of file
+// ===== ARRAY KERNELS =====
+// Arrays of any shape and strides are walked one innermost row at a time.
+// Rows with unit stride go to the SIMD kernels; other rows use plain
+// strided loops. None of this touches Python objects, so the GIL is not
+// taken and :threaded callers can run kernels in parallel.
+//
+// Return codes: 0 ok, -1 not float64, -2 empty, -3 shapes differ,
+// -4 read-only.
+
+#define ARRAY_OK 0
+#define ARRAY_NOT_FLOAT64 -1
+#define ARRAY_EMPTY -2
+#define ARRAY_SHAPE_MISMATCH -3
+#define ARRAY_READONLY -4
+
+enum { REDUCE_SUM = 0, REDUCE_MIN = 1, REDUCE_MAX = 2 };
+
+static int is_float64(const PythonArrayInfo *a) {
+    return a->itemsize == 8 && strcmp(a->format, "d") == 0;
+}
+
+static int64_t row_length(const PythonArrayInfo *a) {
+    return a->ndim ? a->shape[a->ndim - 1] : 1;
+}
+
+static int64_t row_stride(const PythonArrayInfo *a) {
+    return a->ndim ? a->strides[a->ndim - 1] : a->itemsize;
+}
+
+// Start of row k, counting rows in C order
+static char* row_start(const PythonArrayInfo *a, int64_t k) {
+    char *p = a->data;
+    for (int64_t d = a->ndim - 2; d >= 0; d--) {
+        p += (k % a->shape[d]) * a->strides[d];
+        k /= a->shape[d];
+    }
+    return p;
+}
+
+static int same_shape(const PythonArrayInfo *a, const PythonArrayInfo *b) {
+    if (a->ndim != b->ndim) return 0;
+    for (int64_t d = 0; d < a->ndim; d++) {
+        if (a->shape[d] != b->shape[d]) return 0;
+    }
+    return 1;
+}
+
+int python3_array_reduce(PythonArrayInfo *a, int op, double *out) {
+    if (!is_float64(a)) return ARRAY_NOT_FLOAT64;
+    if (a->size == 0 && op != REDUCE_SUM) return ARRAY_EMPTY;
+
+    const ArrayKernels *k = array_kernels();
+    int64_t n = row_length(a), stride = row_stride(a);
+    int64_t rows = n ? a->size / n : 0;
+    double result = op == REDUCE_SUM ? 0.0 : op == REDUCE_MIN ? INFINITY : -INFINITY;
+
+    for (int64_t r = 0; r < rows; r++) {
+        const char *row = row_start(a, r);
+        double value;
+        if (stride == 8) {
+            const double *x = (const double *)row;
+            value = op == REDUCE_SUM ? k->sum(x, n) : op == REDUCE_MIN ? k->min(x, n) : k->max(x, n);
+        } else {
+            value = op == REDUCE_SUM ? 0.0 : op == REDUCE_MIN ? INFINITY : -INFINITY;
+            for (int64_t i = 0; i < n; i++) {
+                double x = *(const double *)(row + i * stride);
+                if (op == REDUCE_SUM) value += x;
+                else if (isnan(x)) { value = NAN; break; }
+                else if (op == REDUCE_MIN ? x < value : x > value) value = x;
+            }
+        }
+
+        if (op == REDUCE_SUM) {
+            result += value;
+        } else if (isnan(value)) {
+            result = NAN;
+            break;
+        } else if (op == REDUCE_MIN ? value < result : value > result) {
+            result = value;
+        }
+    }
+
+    *out = result;
+    return ARRAY_OK;
+}
+
+int python3_array_dot(PythonArrayInfo *a, PythonArrayInfo *b, double *out) {
+    if (!is_float64(a) || !is_float64(b)) return ARRAY_NOT_FLOAT64;
+    if (!same_shape(a, b)) return ARRAY_SHAPE_MISMATCH;
+
+    const ArrayKernels *k = array_kernels();
+    int64_t n = row_length(a), sa = row_stride(a), sb = row_stride(b);
+    int64_t rows = n ? a->size / n : 0;
+    double total = 0.0;
+
+    for (int64_t r = 0; r < rows; r++) {
+        const char *x = row_start(a, r), *y = row_start(b, r);
+        if (sa == 8 && sb == 8) {
+            total += k->dot((const double *)x, (const double *)y, n);
+        } else {
+            for (int64_t i = 0; i < n; i++) {
+                total += *(const double *)(x + i * sa) * *(const double *)(y + i * sb);
+            }
+        }
+    }
+
+    *out = total;
+    return ARRAY_OK;
+}
+
+// y += alpha * x
+int python3_array_axpy(double alpha, PythonArrayInfo *x, PythonArrayInfo *y) {
+    if (!is_float64(x) || !is_float64(y)) return ARRAY_NOT_FLOAT64;
+    if (!same_shape(x, y)) return ARRAY_SHAPE_MISMATCH;
+    if (y->readonly) return ARRAY_READONLY;
+
+    const ArrayKernels *k = array_kernels();
+    int64_t n = row_length(y), sx = row_stride(x), sy = row_stride(y);
+    int64_t rows = n ? y->size / n : 0;
+
+    for (int64_t r = 0; r < rows; r++) {
+        const char *xs = row_start(x, r);
+        char *ys = row_start(y, r);
+        if (sx == 8 && sy == 8) {
+            k->axpy(alpha, (const double *)xs, (double *)ys, n);
+        } else {
+            for (int64_t i = 0; i < n; i++) {
+                *(double *)(ys + i * sy) += alpha * *(const double *)(xs + i * sx);
+            }
+        }
+    }
+    return ARRAY_OK;
+}
+
+// x *= alpha
+int python3_array_scale(double alpha, PythonArrayInfo *x) {
+    if (!is_float64(x)) return ARRAY_NOT_FLOAT64;
+    if (x->readonly) return ARRAY_READONLY;
+
+    const ArrayKernels *k = array_kernels();
+    int64_t n = row_length(x), stride = row_stride(x);
+    int64_t rows = n ? x->size / n : 0;
+
+    for (int64_t r = 0; r < rows; r++) {
+        char *row = row_start(x, r);
+        if (stride == 8) {
+            k->scale(alpha, (double *)row, n);
+        } else {
+            for (int64_t i = 0; i < n; i++) {
+                *(double *)(row + i * stride) *= alpha;
+            }
+        }
+    }
+    return ARRAY_OK;
+}
@@ -1,8 +1,9 @@
 use v6.d;
 use Test;
 use Inline::Python3;
+use Inline::Python3::Config;
 
-plan 20;
+plan 22;
 
 # Test 1: Can create instance
 my $py;
@@ -69,4 +70,17 @@ is $kwarg_test(5), 35, 'Function with default kwargs';
 is $kwarg_test(5, :b(15)), 40, 'Function with named kwargs';
 is $kwarg_test(5, :b(15), :c(25)), 45, 'Multiple kwargs';
 
+# Test 21-22: Build-time configuration cache
+my $python = $*EXECUTABLE;  # Any existing file stands in for the interpreter
+my $cache = $*TMPDIR.add("inline-python3-config-$*PID");
+LEAVE { $cache.unlink }
+PythonConfig.new(:python-executable(~$python), :python-version<3.12.1>, :include-dirs</a /b>).save($cache);
+my $loaded = PythonConfig.load($cache);
+is-deeply ($loaded.python-executable, $loaded.python-version, $loaded.include-dirs.List),
+    (~$python, '3.12.1', </a /b>), 'Cached configuration loads without detection';
+{
+    temp %*ENV<INLINE_PYTHON_VERSION> = '3.9';
+    nok PythonConfig.load($cache).defined, 'A different requested version makes the cache stale';
+}
+
 done-testing;
\ No newline at end of file
@@ -2,7 +2,7 @@ use v6.d;
 use Test;
 use Inline::Python3;
 
-plan 15;
+plan 35;
 
 my $py = Inline::Python3.new;
 
@@ -78,4 +78,44 @@ PYTHON
 my $check_bytes = $py.run('check_bytes', :eval);
 ok $check_bytes($blob), 'Raku Blob -> Python bytes';
 
+# Python containers -> Raku (single-pass tagged buffer conversion)
+my $tree = $py.run('{"rows": [{"id": 1, "tags": ("a", "ü")}, None], "ratio": 0.25}', :eval);
+is $tree<rows>[0]<id>, 1, 'Nested dict inside list converted';
+is-deeply $tree<rows>[0]<tags>.List, ('a', 'ü'), 'Tuple of unicode strings converted';
+ok $tree<rows>[1] ~~ Any && !$tree<rows>[1].defined, 'None inside list converts to Any';
+is $py.run('[2**70]', :eval)[0], 2**70, 'Big integers inside containers keep full precision';
+ok $py.run('[object()]', :eval)[0] ~~ Inline::Python3::PythonObject, 'Opaque objects inside containers are wrapped';
+
+# Big integers in both directions
+is $py.run('-2**100', :eval), -2**100, 'Python big integer -> Raku Int';
+my $identity = $py.run('lambda x: x', :eval);
+is $identity(2**64), 2**64, 'Raku Int beyond 64 bits round-trips';
+is $py.run('lambda x: x == -3**50', :eval)(-3**50), True, 'Negative big integers are not truncated';
+
+# Strings are decoded from the UTF-8 data in place or from one shared arena
+is $py.run('"a\\x00b"', :eval), "a\0b", 'Embedded NUL in a str survives';
+is-deeply $py.run('["", "naïve", "", "e\\u0301", "\\u0301x", "日本"]', :eval).List,
+    ('', 'naïve', '', "e\x[301]", "\x[301]x", '日本'), 'List of strings keeps empty strings and combining marks apart';
+is-deeply $py.run('["x\\x00y", b"\\x00", "z"]', :eval).List, ("x\0y", Blob.new(0), 'z'), 'Strings next to NULs and bytes in a list';
+is $py.run('[str(i) for i in range(10000)]', :eval).join(','), (^10000).join(','), 'Large list of strings decoded in order';
+
+# Long numeric lists cross as native arrays
+my $ints = $py.run('list(range(100000))', :eval);
+ok $ints ~~ array[int64] && $ints.sum == 4999950000, 'Python list of ints -> native int array';
+my $floats = $py.run('[i / 2 for i in range(1000)]', :eval);
+ok $floats ~~ array[num64] && $floats[999] == 499.5e0, 'Python list of floats -> native num array';
+ok $py.run('[True] * 200 + [2**70]', :eval)[0] ~~ Bool, 'Lists of bools and big integers are not unboxed';
+my $sum = $py.run('lambda xs: (type(xs).__name__, sum(xs))', :eval);
+my int64 @native = ^100000;
+is-deeply $sum($@native).List, ('list', 4999950000), 'Native int array -> Python list';
+is-deeply $sum($[(^1000).map(* + 0.5e0)]).List, ('list', 500000e0), 'Array of Nums -> Python list of floats';
+is-deeply $sum($[|(^200), 2**70]).List, ('list', 19900 + 2**70), 'Arrays with big integers keep full precision';
+
+# Constants passed from the helper's table
+$py.run('import sys; probe = lambda *a: a');
+my $probe = $py.run('probe', :eval);
+$probe(0, 256, -5, True, False, Any, '') for ^1000;
+is-deeply $probe(7, True, Any, '').List, (7, True, Any, ''), 'Small ints, bools, None and empty str pass through';
+ok $py.run('sys.getrefcount(None) > 1000 and sys.getrefcount(7) > 10', :eval), 'Constant table leaves refcounts intact';
+
 done-testing;
\ No newline at end of file
@@ -2,7 +2,7 @@ use v6.d;
 use Test;
 use Inline::Python3;
 
-plan 8;
+plan 11;
 
 my $py = Inline::Python3.new;
 
@@ -54,4 +54,23 @@ ok $error.python-traceback.defined, 'Traceback is captured';
 ok $error.python-traceback ~~ /inner/ && $error.python-traceback ~~ /outer/, 
    'Traceback contains call stack';
 
+# Tracebacks are only formatted when they are read
+$py.run(q:to/PYTHON/);
+import sys
+sys.modules.pop("traceback", None)
+def lookup(key):
+    return {}[key]
+PYTHON
+my $lookup = $py.run('lookup', :eval);
+my $caught = 0;
+for ^100 {
+    $lookup('missing');
+    CATCH { when Inline::Python3::PythonError { $caught++ } }
+}
+is $caught, 100, 'Control-flow exceptions are caught in Raku';
+ok $py.run('"traceback" not in sys.modules', :eval), 'Caught exceptions never format a traceback';
+
+try $lookup('missing');
+ok $!.message ~~ /KeyError .* Traceback/, 'Traceback is formatted when the message is read';
+
 done-testing;
\ No newline at end of file
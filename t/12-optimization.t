@@ -3,7 +3,7 @@ use Test;
 use lib 'lib';
 use Inline::Python3;
 
-plan 10;
+plan 21;
 
 # Test built-in optimization features
 my $py = Inline::Python3.new;
@@ -25,6 +25,15 @@ class MyClass:
 
 obj = MyClass(10)
 
+# No instance dict, so the method cache answers on every Python version
+class Slotted:
+    __slots__ = ('value',)
+    def __init__(self, value):
+        self.value = value
+    
+    def double(self):
+        return self.value * 2
+
 # For string interning test
 string_list = ["test", "test", "test", "hello", "hello"]
 PYTHON
@@ -61,4 +70,44 @@ for ^5 -> $i {
 }
 ok @strings[0] eq @strings[1] eq @strings[2], 'Repeated strings handled correctly';
 
+# Test 11-12: Compiled code cache
+$py.clear-caches;
+$py.run('counter = 0');
+$py.run('counter += 1') for ^10;
+my %stats = $py.cache-stats;
+ok %stats<hits> >= 9, 'Repeated run() is served from the code cache';
+is $py.run('counter', :eval), 10, 'Cached code still runs every time';
+
+# Test 13: Explicitly compiled code
+my $code = $py.compile('counter * 2', :eval);
+is $py.run($code), 20, 'Compiled code object runs against the globals';
+
+# Test 14-15: Syntax errors are not cached
+throws-like { $py.run('1 +', :eval) }, Inline::Python3::PythonError,
+    python-type => /SyntaxError/, 'Syntax errors are raised';
+throws-like { $py.run('1 +', :eval) }, Inline::Python3::PythonError,
+    python-type => /SyntaxError/, 'Syntax errors are raised again on the next run';
+
+# Test 16: Only code objects can be run
+throws-like { $py.run($py.run('object()', :eval)) }, Inline::Python3::PythonError,
+    python-type => /TypeError/, 'Running a non-code object raises TypeError';
+
+# Test 17-19: Native method resolution cache
+my $slotted = $py.run('Slotted(10)', :eval);
+$slotted.double() for ^10;
+ok $py.method-cache-stats<hits> >= 9, 'Repeated method calls hit the native method cache';
+$py.run('MyClass.double = lambda self: self.value * 3');
+is $obj.double(), 30, 'Redefining a method on the class invalidates the cache';
+$py.run('obj.double = lambda: "instance"');
+is $obj.double(), 'instance', 'Instance attributes still shadow class methods';
+
+# Test 20-21: Wrappers share per-type data by type object, not by name
+is-deeply ($obj.type-name, $py.run('__import__("collections").OrderedDict()', :eval).type-name),
+    ('MyClass', 'collections.OrderedDict'), 'Type names are read on demand';
+my @points = $py.run(q:to/PYTHON/, :eval);
+[type("Point", (), {"side": (lambda s: lambda self: s)(s)})() for s in "ab"]
+PYTHON
+is-deeply @points.map({ (.type-name, .side) }).List, (<Point a>, <Point b>),
+    'Distinct classes with the same name keep their own methods';
+
 done-testing;
\ No newline at end of file
@@ -0,0 +1,47 @@
+use v6.d;
+use Test;
+use lib 'lib';
+use Inline::Python3;
+
+plan 6;
+
+my $py = Inline::Python3.new(:threaded);
+ok $py.threads-enabled, 'Threaded mode releases the GIL after init';
+
+$py.run(q:to/PYTHON/);
+import time
+
+def square(x):
+    return x * x
+
+def nap(seconds):
+    time.sleep(seconds)
+    return seconds
+PYTHON
+
+my $square = $py.run('square', :eval);
+
+# Many Raku threads calling into the same instance
+my @results = await (^8).map: -> $t {
+    start { (^100).map({ $square($t * 100 + $_) }).sum }
+};
+is @results.sum, (^800).map(* ** 2).sum, 'Concurrent calls from Raku threads return correct results';
+
+# Errors raised on worker threads reach the calling thread
+my @errors = await (^4).map: {
+    start { try { $py.run('{}["missing"]', :eval); Nil } // $! }
+};
+ok @errors.all ~~ Inline::Python3::PythonError, 'Python exceptions propagate from worker threads';
+ok @errors.map(*.python-type).all ~~ /KeyError/, 'Exception type is preserved per thread';
+
+# time.sleep drops the GIL, so the naps overlap
+my $nap = $py.run('nap', :eval);
+my $start = now;
+await (^4).map: { start { $nap(0.25) } };
+ok now - $start < 0.8, 'Calls that release the GIL run concurrently';
+
+# Holding the GIL across a batch of calls
+my $sum = $py.with-gil: { (^50).map({ $square($_) }).sum };
+is $sum, (^50).map(* ** 2).sum, 'with-gil runs a batch of calls under one GIL acquisition';
+
+done-testing;
@@ -0,0 +1,49 @@
+use v6.d;
+use Test;
+use lib 'lib';
+use Inline::Python3;
+use Inline::Python3::Pool;
+
+plan 7;
+
+my $pool = Inline::Python3::Pool.new(:size(3));
+is $pool.size, 3, 'Pool starts the requested number of sub-interpreters';
+
+$pool.run-all(q:to/PYTHON/);
+def burn(n):
+    total = 0
+    for i in range(n):
+        total += i
+    return total
+
+def whoami(tag):
+    global last
+    last = tag
+    return tag
+PYTHON
+
+my @totals = await (^6).map({ $pool.call('burn', 10_000) });
+is @totals, (49995000 xx 6).List, 'Calls are dispatched across members and return plain data';
+
+# Members have separate globals
+await (^3).map(-> $i { $pool.call('whoami', "member-$i", :on($i)) });
+my @seen = await (^3).map(-> $i { $pool.run('last', :eval, :on($i)) });
+is @seen, <member-0 member-1 member-2>, 'Each member keeps its own globals';
+
+is await($pool.call('burn', :n(10))), 45, 'Keyword arguments reach pool functions';
+
+# Errors break the task's promise
+my $failed = $pool.run('1/0', :eval);
+throws-like { await $failed }, Inline::Python3::PythonError,
+    python-type => /ZeroDivisionError/, 'Python exceptions break the promise';
+
+throws-like { await $pool.run('object()', :eval) }, Exception,
+    message => /'plain data'/, 'Opaque Python objects cannot leave a member';
+
+# The main interpreter is unaffected by pool members
+my $py = Inline::Python3.new;
+$py.run('last = "main"');
+$pool.shutdown;
+is $py.run('last', :eval), 'main', 'Main interpreter keeps its own state after shutdown';
+
+done-testing;
@@ -0,0 +1,53 @@
+use v6.d;
+use Test;
+use lib 'lib';
+use Inline::Python3;
+
+plan 13;
+
+my $py = Inline::Python3.new;
+
+# Python buffers viewed from Raku
+$py.run('data = bytearray(b"hello world")');
+my $data = $py.run('data', :eval);
+
+my $view = $py.buffer($data, :writable);
+is $view.elems, 11, 'Buffer view reports the byte length';
+is $view.decode, 'hello world', 'Buffer view reads Python memory';
+
+$view[0] = 'H'.ord;
+$view.write('W'.encode, 6);
+is $py.run('bytes(data)', :eval).decode, 'Hello World', 'Writes through the view reach Python';
+
+throws-like { $py.run('data.extend(b"!")') }, Exception, message => /BufferError/,
+    'Pinned bytearray cannot be resized';
+$view.release;
+$py.run('data.extend(b"!")');
+is $py.run('len(data)', :eval), 12, 'Released view unpins the bytearray';
+
+my $ro = $py.buffer($py.run('b"\x00\x01\x02"', :eval));
+ok $ro.readonly && $ro.subbuf(1) eq Blob.new(1, 2), 'Read-only view of bytes';
+dies-ok { $ro[0] = 9 }, 'Read-only view rejects writes';
+
+# Raku buffers viewed from Python
+my $buf = buf8.new(1, 2, 3, 4);
+my $mv = $py.memoryview($buf, :writable);
+$py.run('lambda m: m.__setitem__(0, 42)', :eval)($mv);
+is $buf[0], 42, 'Python writes into a Raku Buf through a memoryview';
+is $py.run('lambda m: sum(m[1:])', :eval)($mv), 9, 'Python reads a Raku Buf without copying';
+dies-ok { $py.memoryview(Blob.new(1, 2), :writable) }, 'Writable memoryview needs a Buf';
+
+# Native arrays keep their element type
+my num64 @samples = 0.5e0, 1.5e0, 2e0;
+is $py.run('lambda m: (m.format, len(m), sum(m))', :eval)($py.memoryview(@samples)),
+    ['d', 3, 4e0], 'array[num64] becomes a typed memoryview';
+
+my int64 @counts = 1, 2, 3;
+$py.run('lambda m: m.__setitem__(1, -20)', :eval)($py.memoryview(@counts, :writable));
+is @counts[1], -20, 'Python writes into a native int array';
+
+my $samples = $py.ndarray(@samples, :writable);
+$py.run('lambda a: a.__setitem__(2, 8.0)', :eval)($samples);
+is @samples[2], 8e0, 'ndarray shares memory with the native array';
+
+done-testing;
@@ -0,0 +1,61 @@
+use v6.d;
+use Test;
+use lib 'lib';
+use Inline::Python3;
+
+plan 14;
+
+my $py = Inline::Python3.new;
+
+# Iterables streamed into lazy Seqs
+$py.run(q:to/PYTHON/);
+import sys, itertools
+sys.modules.pop("traceback", None)
+
+def squares(n):
+    for i in range(n):
+        yield i * i
+
+def failing():
+    yield 1
+    raise ValueError("cursor lost")
+PYTHON
+
+my $squares = $py.run('squares(10)', :eval);
+is-deeply $squares.Seq(:chunk(3)).List, (0, 1, 4, 9, 16, 25, 36, 49, 64, 81), 'Generator streams through chunks';
+
+my $count = $py.iterate($py.run('itertools.count()', :eval), :chunk(4));
+ok $count.is-lazy, 'Iteration Seq is lazy';
+is-deeply $count.head(6).List, (0, 1, 2, 3, 4, 5), 'Infinite iterators can be consumed partially';
+
+is $py.iterate($py.run('range(200000)', :eval)).sum, 19999900000, 'Large range streams in constant memory';
+ok $py.run('"traceback" not in sys.modules', :eval), 'Exhaustion does not go through exception formatting';
+
+throws-like { $py.run('failing()', :eval).Seq.List }, Inline::Python3::PythonError,
+    python-message => /'cursor lost'/, 'Errors raised while iterating propagate';
+throws-like { $py.iterate($py.run('object()', :eval)) }, Inline::Python3::PythonError,
+    python-type => /TypeError/, 'Non-iterables are rejected';
+
+# Lazy container proxies
+$py.run(q:to/PYTHON/);
+big = {f"key{i}": {"id": i, "tags": ["a", "b"]} for i in range(50000)}
+big[7] = None
+rows = [(i, str(i)) for i in range(10)]
+PYTHON
+
+my $big = $py.run('big', :eval, :lazy);
+ok $big ~~ Inline::Python3::PythonDictProxy, 'Dict result comes back as a proxy';
+is $big.elems, 50001, 'Proxy knows the dict size without converting it';
+is $big<key42><tags>[1], 'b', 'Nested lookups convert only what is read';
+ok $big{7}:exists && !$big{7}.defined && !($big<missing>:exists), 'Keys keep their Python types; None values exist';
+
+my $grid = $py.run('{(0, 0): "origin", (1, 2): "point"}', :eval, :lazy);
+is-deeply $grid.pairs.map({ .key.join(',') ~ '=' ~ .value }).sort.List, ('0,0=origin', '1,2=point'),
+    'Tuple keys are looked up with their Python key objects';
+
+my $rows = $py.run('rows', :eval, :lazy);
+is-deeply $rows[3].List, (3, '3'), 'List proxy converts elements on access';
+my $lazy-py = Inline::Python3.new(:lazy);
+is $lazy-py.run('[(i, str(i)) for i in range(10)]', :eval).map(*[1]).join, '0123456789', 'Instances created with :lazy return proxies that iterate';
+
+done-testing;
@@ -0,0 +1,51 @@
+use v6.d;
+use Test;
+use lib 'lib';
+use Inline::Python3;
+use Inline::Python3::NumPy;
+
+plan 12;
+
+my $py = Inline::Python3.new;
+
+# Strided arrays through the buffer protocol; no NumPy needed
+$py.run(q:to/PYTHON/);
+import array, math
+grid = memoryview(array.array('d', range(6))).cast('B').cast('d', (2, 3))
+data = array.array('d', [0.5 * i - 3 for i in range(101)])
+other = array.array('d', [1.0 / (i + 1) for i in range(102)])
+evens = memoryview(data)[::2]
+odds = memoryview(other)[1::2]
+PYTHON
+
+my $grid = $py.numpy-array($py.run('grid', :eval));
+is-deeply ($grid.dtype, $grid.shape, $grid.strides), ('float64', [2, 3], [24, 8]),
+    'Metadata comes back in one call';
+ok $grid.is-c-contiguous && !$grid.is-f-contiguous, 'Contiguity is derived from the strides';
+is $grid[1;2], 5e0, 'Multi-dimensional element access';
+
+my $evens = $py.numpy-array($py.run('evens', :eval));
+ok !$evens.is-contiguous && $evens.strides[0] == 16, 'Step slices are strided views';
+$evens[3] = 42e0;
+is $py.run('data[6]', :eval), 42e0, 'Writes through a strided view reach Python';
+
+my $ints = $py.numpy-array($py.run('memoryview(array.array("i", [7, -8, 9]))', :eval));
+is-deeply ($ints.dtype, $ints.to-array), ('int32', [7, -8, 9]), 'Non-float dtypes are readable';
+
+# Kernels
+is-approx $evens.sum, $py.run('math.fsum(evens)', :eval), 'sum over a strided view';
+is-deeply ($evens.min, $evens.max), ($py.run('min(evens)', :eval), $py.run('max(evens)', :eval)),
+    'min and max';
+my $odds = $py.numpy-array($py.run('odds', :eval));
+my $data = $py.numpy-array($py.run('memoryview(data)', :eval));
+dies-ok { $data.dot($odds) }, 'Kernels check shapes';
+is-approx $evens.dot($odds), $py.run('math.fsum(x * y for x, y in zip(evens, odds))', :eval),
+    'dot of two strided views';
+
+my @scaled = $data.scale(2).to-array.head(3);
+$data.axpy(-0.5, $data);
+is-deeply (|@scaled, $py.run('data[0]', :eval)), (-6e0, -5e0, -4e0, -3e0),
+    'scale and axpy update the array in place';
+dies-ok { $ints.sum }, 'Kernels need float64 arrays';
+
+done-testing;
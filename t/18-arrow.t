@@ -0,0 +1,60 @@
+use v6.d;
+use Test;
+use lib 'lib';
+use Inline::Python3;
+use Inline::Python3::Arrow;
+
+plan 12;
+
+my $py = Inline::Python3.new;
+
+unless $py.run('__import__("importlib.util").util.find_spec("pyarrow") is not None', :eval) {
+    skip-rest 'pyarrow is not installed';
+    exit;
+}
+
+$py.run(q:to/PYTHON/);
+import pyarrow as pa
+batch = pa.record_batch({
+    "id": pa.array([1, 2, None, 4], type=pa.int64()),
+    "score": pa.array([0.5, 1.5, 2.5, 3.5]),
+    "name": ["alpha", None, "", "δέλτα"],
+    "flag": [True, False, None, True],
+})
+PYTHON
+
+# pyarrow to Raku
+my $batch = $py.arrow-batch($py.run('batch', :eval));
+is-deeply ($batch.names, $batch.elems), (<id score name flag>, 4), 'Batch schema and length';
+is-deeply $batch<id>.list, (1, 2, Any, 4), 'Integer column with a null';
+ok $batch<score>.values ~~ CArray[num64] && $batch<score>.values[3] == 3.5e0,
+    'Float values are read from the Arrow buffer';
+is-deeply $batch<name>.list, ('alpha', Any, '', 'δέλτα'), 'String column with nulls and UTF-8';
+is-deeply $batch<flag>.list, (True, False, Any, True), 'Bit-packed booleans';
+
+my $slice = $py.arrow-column($py.run('batch.column(0).slice(2)', :eval));
+is-deeply ($slice.offset, $slice.null-count, $slice.list), (2, 1, (Any, 4)), 'Sliced columns keep their offset';
+
+# Raku to pyarrow
+my num64 @prices = 9.5e0, 12e0, 7.25e0;
+my $prices = $py.to-arrow(@prices);
+is $py.run('lambda a: (str(a.type), a.to_pylist())', :eval)($prices), ['double', [9.5e0, 12e0, 7.25e0]],
+    'Native arrays become typed Arrow arrays';
+@prices[1] = 13e0;
+is $py.run('lambda a: a[1].as_py()', :eval)($prices), 13e0, 'Exported column shares the Raku memory';
+
+my $names = $py.to-arrow(['x', Any, 'ünï']);
+is-deeply $py.run('lambda a: (a.null_count, a.to_pylist())', :eval)($names), [1, ['x', Any, 'ünï']],
+    'String lists become utf8 arrays with nulls';
+
+my $counts = $py.to-arrow([1, Any, 3]);
+is-deeply $py.run('lambda a: (str(a.type), a.to_pylist())', :eval)($counts), ['int64', [1, Any, 3]],
+    'Int lists become int64 arrays with nulls';
+dies-ok { $py.to-arrow([1, 'two']) }, 'Mixed lists are refused';
+
+my int32 @qty = 3, 1, 2;
+my $rb = $py.to-arrow-batch(qty => @qty, name => <a b c>);
+is $py.run('lambda b: (b.schema.names, b.column(0).to_pylist())', :eval)($rb), [<qty name>, [3, 1, 2]],
+    'Record batches from Raku columns';
+
+done-testing;
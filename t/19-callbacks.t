@@ -0,0 +1,70 @@
+use v6.d;
+use Test;
+use lib 'lib';
+use Inline::Python3;
+
+plan 12;
+
+my $py = Inline::Python3.new;
+
+$py.run(q:to/PYTHON/);
+def sort_by(items, key):
+    return sorted(items, key=key)
+
+def call_with(f, *args, **kwargs):
+    return f(*args, **kwargs)
+
+def attr_of(obj, name):
+    return getattr(obj, name)
+
+def drop_after_attr(obj, name):
+    import gc
+    gc.disable()
+    getattr(obj, name)
+    del obj
+    gc.enable()
+
+def call_method(obj, name, *args):
+    return getattr(obj, name)(*args)
+
+def batched_map(f, items):
+    return list(f.map(items))
+
+def fails(f):
+    try:
+        f()
+    except RuntimeError as e:
+        return str(e)
+PYTHON
+
+is-deeply $py.call-global('sort_by', $[3, 1, 2, 5, 4], -> $x { -$x }), [5, 4, 3, 2, 1],
+    'Raku closure as sorted() key';
+is $py.call-global('call_with', -> $a, $b, :$scale = 1 { ($a + $b) * $scale }, 2, 3, :scale(10)), 50,
+    'Positional and keyword arguments reach the closure';
+is $py.call-global('call_with', -> $s { $s.uc }, 'raku'), 'RAKU', 'Strings round-trip';
+
+class Counter {
+    has $.count = 0;
+    method bump($by = 1) { $!count += $by }
+}
+my $counter = $py.raku-object(Counter.new);
+is $py.call-global('call_method', $counter, 'bump', 5), 5, 'Attribute access calls Raku methods';
+my $live = $py.raku-object-stats<live>;
+$py.call-global('drop_after_attr', -> { 1 }, 'arity') for ^100;
+ok $py.raku-object-stats<live> - $live < 5, 'Objects with methods read are freed without the cycle collector';
+is $py.call-global('fails', -> { die 'broken' }), 'broken', 'Raku exceptions become RuntimeError';
+
+my $calls = 0;
+my $double = $py.batched(-> $x { $calls++; $x * 2 }, :chunk(100));
+is $py.call-global('batched_map', $double, $((^250).Array)).join(','), (^250).map(* * 2).join(','),
+    'Batched map returns one result per item';
+is $calls, 250, 'Batched map calls the closure once per item';
+is $py.call-global('call_with', $double, 21), 42, 'Batched callables can still be called directly';
+
+dies-ok { $py.batched(-> $x { $x }, :chunk(0)) }, 'Chunk size must be positive';
+
+# Slots come back once Python drops its RakuObject
+$py.call-global('call_with', -> $x { $x }, $_) for ^1000;
+my %stats = $py.raku-object-stats;
+ok %stats<registered> >= 1000, 'Every registration is counted';
+ok %stats<live> < 10 && %stats<slots> < 20, 'Released slots are reused';
@@ -0,0 +1,68 @@
+use v6.d;
+use Test;
+use lib 'lib';
+use Inline::Python3;
+use Inline::Python3::Async;
+
+plan 9;
+
+my $py = Inline::Python3.new(:threaded);
+$py.run(q:to/PYTHON/);
+import asyncio
+
+servers = []
+
+async def echo_server():
+    async def handle(reader, writer):
+        while True:
+            line = await reader.readline()
+            if not line:
+                break
+            writer.write(line)
+            await writer.drain()
+        writer.close()
+    server = await asyncio.start_server(handle, '127.0.0.1', 0)
+    servers.append(server)
+    return server.sockets[0].getsockname()[1]
+
+async def echo(port, message):
+    reader, writer = await asyncio.open_connection('127.0.0.1', port)
+    writer.write(message.encode() + b'\n')
+    await writer.drain()
+    line = await reader.readline()
+    writer.close()
+    return line.decode().rstrip()
+
+async def slow(n):
+    await asyncio.sleep(0.5)
+    return n
+
+async def fail():
+    raise ValueError('no luck')
+PYTHON
+
+dies-ok { Inline::Python3::Async.new(:python(Inline::Python3.new)) }, 'Needs a threaded instance';
+
+my $async = Inline::Python3::Async.new(:python($py));
+
+my $port = await $async.call('echo_server');
+ok $port > 0, 'Echo server is listening on the loop';
+
+my @replies = await (^200).map({ $async.call('echo', $port, "message $_") });
+is-deeply @replies, (^200).map({ "message $_" }).Array, 'Hundreds of concurrent connections';
+
+my $started = now;
+my @slow = await (^100).map({ $async.call('slow', $_) });
+is @slow.sum, (^100).sum, 'Results arrive as Promises';
+ok now - $started < 3, 'Waits overlap on the loop';
+
+throws-like { await $async.call('fail') }, Inline::Python3::PythonError,
+    python-message => 'no luck', 'Exceptions break the Promise';
+
+throws-like { $py.with-gil({ $async.stop }) }, Exception, message => /GIL/,
+    'Stopping while holding the GIL is refused';
+
+my $pending = $async.run('asyncio.sleep(60)');
+$async.stop;
+is $pending.status, Broken, 'Stopping cancels pending awaitables';
+dies-ok { $async.run('asyncio.sleep(0)') }, 'No submissions after stop';
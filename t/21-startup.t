@@ -0,0 +1,36 @@
+use v6.d;
+use Test;
+use lib 'lib';
+use Inline::Python3;
+
+plan 9;
+
+# The first instance in the process starts the interpreter, so this file
+# must not create any other instance before it
+my $dir = $*TMPDIR.add("inline-python3-startup-$*PID");
+$dir.mkdir;
+$dir.add('startup_probe.py').spurt("VALUE = 42\n");
+END { .unlink for $dir.dir; $dir.rmdir }
+
+my $py;
+lives-ok {
+    $py = Inline::Python3.new(:!site-import, :optimize(2), :allocator<malloc>,
+                              :module-path($dir), :preload<json decimal>)
+}, 'Starts with a custom profile';
+
+ok $py.run('sys.flags.no_site == 1 and "site" not in sys.modules', :eval), 'site is not imported';
+is $py.run('sys.flags.optimize', :eval), 2, 'Optimization level';
+is $py.run('__import__("startup_probe").VALUE', :eval), 42, 'Module path comes first';
+ok $py.run('"json" in sys.modules and "decimal" in sys.modules', :eval), 'Preload modules are imported';
+
+my %times = $py.init-times;
+is %times.keys.sort, <initialize instance pre-initialize preload>, 'Init time per phase';
+ok %times<initialize> > 0 && %times<preload> > 0, 'Phases are measured';
+
+my $warned = False;
+{
+    CONTROL { when CX::Warn { $warned = True; .resume } }
+    Inline::Python3.new(:preload<json>);
+}
+ok $warned, 'Settings of later instances are ignored, with a warning';
+dies-ok { Inline::Python3.new(:allocator<bogus>) }, 'Unknown allocators are rejected';
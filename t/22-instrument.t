@@ -0,0 +1,30 @@
+use v6.d;
+use Test;
+use lib 'lib';
+use Inline::Python3;
+use Inline::Python3::Performance::Monitor;
+
+plan 7;
+
+my $py = Inline::Python3.new;
+$py.run('def length(s): return len(s)');
+my $monitor = get-performance-monitor();
+
+my %before = $monitor.native-snapshot;
+nok %before<enabled>, 'Off by default';
+is %before<entry-points>.elems, 0, 'Nothing is counted while off';
+
+$monitor.instrument;
+is $py.call-global('length', 'x' x 100), 100, 'Calls work while instrumented';
+my $text = $py.run('"y" * 1000', :eval);
+try $py.run('1 / 0');
+$monitor.instrument(False);
+
+my %snapshot = $monitor.native-snapshot;
+ok so %snapshot<entry-points><python3_vectorcall python3_eval python3_fetch_exception>.map({ $_ && $_<calls> > 0 }).all,
+    'The entry points used are counted';
+ok %snapshot<bytes-to-python> >= 100 && %snapshot<bytes-from-python> >= 1000, 'Bytes in both directions';
+is %snapshot<exceptions>, 1, 'Exceptions are counted';
+
+my @objects = (^10).map({ $py.run('object()', :eval) });
+ok $monitor.native-snapshot<wrappers-live> >= 10, 'Live wrappers are counted';
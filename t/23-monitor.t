@@ -0,0 +1,39 @@
+use v6.d;
+use Test;
+use lib 'lib';
+use Inline::Python3;
+use Inline::Python3::Performance::Monitor;
+
+plan 8;
+
+my $py = Inline::Python3.new;
+my $monitor = Inline::Python3::Performance::Monitor.new;
+
+$monitor.record('latency', $_ / 1e6) for 1..1000;
+my %stats = $monitor.stats('latency');
+ok abs(%stats<p50> - 500e-6) < 500e-6 * 0.05 && abs(%stats<p99> - 990e-6) < 990e-6 * 0.05,
+    'Percentiles are within 5%';
+ok %stats<min> == 1e-6 && %stats<max> == 1e-3, 'Min and max are exact';
+
+my $sampled = Inline::Python3::Performance::Monitor.new(:sample-rate(0.1));
+$sampled.time-call('call', { $py.run('1 + 1', :eval) }) for ^1000;
+my %sampled = $sampled.stats('call');
+ok %sampled<count> == 1000 && 30 < %sampled<samples> < 200, 'Sampling times a fraction but counts every call';
+
+my @workers = (^8).map: { start { $monitor.record('threads', 1e-3) for ^1000 } };
+await @workers;
+is $monitor.counts<threads>, 8000, 'Records from many threads all count';
+
+my %parsed = $py.call('json', 'loads', $monitor.to-json);
+is %parsed<labels><latency><count>, 1000, 'JSON export parses';
+
+my $text = $monitor.to-prometheus;
+ok $text.contains('inline_python3_operation_duration_seconds_bucket{label="latency",le="+Inf"} 1000'),
+    'Prometheus export has the +Inf bucket';
+ok $text.contains('inline_python3_operation_duration_seconds_count{label="threads"} 8000'),
+    'Prometheus export has the count';
+
+my $file = $*TMPDIR.add("inline-python3-monitor-$*PID.prom");
+$monitor.export($file);
+LEAVE $file.unlink if $file.e;
+is $file.slurp, $text, 'Export writes the Prometheus text to a file';